@@ -129,20 +129,49 @@ typedef struct XFadeContext {
     char *easing_str; // easing name with optional args
     char *transition_str; // transition name with optional args
     int reverse; // reverse option bit flags (enum ReverseFlags)
+    int incremental; // re-render only changed rows for still inputs
+    int batch; // number of frames to render concurrently
+    int chunk; // rows per slice job, -1 equal bands, 0 adaptive
+    int tile; // tile size for extended transitions, -1 rows, 0 auto
+    int resize; // sampling of second input of different size (enum ResizeMode)
+    int nb_inputs; // more than 2 for a slideshow
+    char *offsets_str; // slideshow cut offsets
+    char *durations_str; // slideshow cut durations
+    int mask; // custom expression is an input weight (MaskMode), evaluated once per pixel for all planes
+    int samples; // easing curve intervals to log as CSV, 0 for none
+    struct XFadeSlideshow *show; // slideshow data
     struct XFadeEasingContext *k; // xfade-easing data
+    double progress[2]; // uneased and eased progress of the frame rendering, for custom expressions
 
-    AVExpr *e;
+    AVExpr **e; // custom expression per slice job, for its own st()/ld() variables, NULL terminated
 } XFadeContext;
 
-static const char *const var_names[] = {   "X",   "Y",   "W",   "H",   "A",   "B",   "PLANE",          "P",        NULL };
-enum                                   { VAR_X, VAR_Y, VAR_W, VAR_H, VAR_A, VAR_B, VAR_PLANE, VAR_PROGRESS, VAR_VARS_NB };
+static const char *const var_names[] = {   "X",   "Y",   "W",   "H",   "A",   "B",   "PLANE",          "P",        "PU",      "PE",      NULL };
+enum                                   { VAR_X, VAR_Y, VAR_W, VAR_H, VAR_A, VAR_B, VAR_PLANE, VAR_PROGRESS, VAR_UNEASED, VAR_EASED, VAR_VARS_NB };
 
 typedef struct ThreadData {
     const AVFrame *xf[2];
     AVFrame *out;
     float progress;
+    float uneased, eased; // progress values used, for frame metadata
 } ThreadData;
 
+typedef struct XFadePlanes { // plane levels read by built-in kernels, all planes or one at its own resolution
+    int nb_planes;
+    int max_value;
+    int is_rgb;
+    uint16_t black[4];
+    uint16_t white[4];
+} XFadePlanes;
+
+typedef void (*XFadeKernel)(const XFadePlanes *s, const AVFrame *a, const AVFrame *b, AVFrame *out, float progress,
+                            int slice_start, int slice_end, int jobnr);
+
+typedef struct ExprData { // custom expression opaque, frames read by a0() to b3()
+    const XFadeContext *s;
+    const AVFrame *xf[2];
+} ExprData;
+
 static const enum AVPixelFormat pix_fmts[] = {
     AV_PIX_FMT_YUVA444P,
     AV_PIX_FMT_YUVJ444P,
@@ -162,22 +191,67 @@ static const enum AVPixelFormat pix_fmts[] = {
     AV_PIX_FMT_NONE
 };
 
+static const enum AVPixelFormat subsampled_pix_fmts[] = {
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUVJ420P, AV_PIX_FMT_YUVA420P,
+    AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUVJ422P, AV_PIX_FMT_YUVA422P,
+    AV_PIX_FMT_YUV420P9, AV_PIX_FMT_YUV422P9, AV_PIX_FMT_YUVA420P9, AV_PIX_FMT_YUVA422P9,
+    AV_PIX_FMT_YUV420P10, AV_PIX_FMT_YUV422P10, AV_PIX_FMT_YUVA420P10, AV_PIX_FMT_YUVA422P10,
+    AV_PIX_FMT_YUV420P12, AV_PIX_FMT_YUV422P12, AV_PIX_FMT_YUVA422P12,
+    AV_PIX_FMT_YUV420P14, AV_PIX_FMT_YUV422P14,
+    AV_PIX_FMT_YUV420P16, AV_PIX_FMT_YUV422P16, AV_PIX_FMT_YUVA420P16, AV_PIX_FMT_YUVA422P16,
+    AV_PIX_FMT_NV12, AV_PIX_FMT_NV21, AV_PIX_FMT_NV16,
+    AV_PIX_FMT_P010, AV_PIX_FMT_P016, AV_PIX_FMT_P210, AV_PIX_FMT_P216,
+    AV_PIX_FMT_NONE
+};
+
+static const enum AVPixelFormat float_pix_fmts[] = {
+    AV_PIX_FMT_GBRPF32, AV_PIX_FMT_GBRAPF32,
+    AV_PIX_FMT_NONE
+};
+
+static const enum AVPixelFormat packed_pix_fmts[] = {
+    AV_PIX_FMT_RGB24, AV_PIX_FMT_BGR24,
+    AV_PIX_FMT_RGBA, AV_PIX_FMT_BGRA, AV_PIX_FMT_ARGB, AV_PIX_FMT_ABGR,
+    AV_PIX_FMT_NONE
+};
+
+static void free_exprs(AVExpr ***e)
+{
+    for (AVExpr **p = *e; p && *p; p++)
+        av_expr_free(*p);
+    av_freep(e);
+}
+
 static void xe_data_free(struct XFadeEasingContext *k);
+static void xe_slideshow_free(XFadeContext *s);
 static av_cold void uninit(AVFilterContext *ctx)
 {
     XFadeContext *s = ctx->priv;
 
-    av_expr_free(s->e);
+    xe_slideshow_free(s);
+    free_exprs(&s->e);
     xe_data_free(s->k);
 }
 
 #define OFFSET(x) offsetof(XFadeContext, x)
 #define FLAGS (AV_OPT_FLAG_FILTERING_PARAM | AV_OPT_FLAG_VIDEO_PARAM)
+#define TFLAGS (FLAGS | AV_OPT_FLAG_RUNTIME_PARAM)
 
 static const AVOption xfade_options[] = {
-    { "easing", "set cross fade easing", OFFSET(easing_str), AV_OPT_TYPE_STRING, {.str=NULL}, 0, 0, FLAGS },
-    { "reverse", "reverse easing/transition", OFFSET(reverse), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 3, FLAGS },
-    { "transition", "set cross fade transition", OFFSET(transition_str), AV_OPT_TYPE_STRING, {.str=NULL}, 0, 0, FLAGS, .unit = "transition" },
+    { "easing", "set cross fade easing", OFFSET(easing_str), AV_OPT_TYPE_STRING, {.str=NULL}, 0, 0, TFLAGS },
+    { "reverse", "reverse easing/transition", OFFSET(reverse), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 3, TFLAGS },
+    { "incremental", "re-render only changed rows of vertical wipes and horzopen/horzclose for still inputs", OFFSET(incremental), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, FLAGS },
+    { "batch", "set number of frames to render concurrently", OFFSET(batch), AV_OPT_TYPE_INT, { .i64 = 1 }, 1, 64, FLAGS },
+    { "chunk", "set rows per slice job, -1 equal bands, 0 adaptive", OFFSET(chunk), AV_OPT_TYPE_INT, { .i64 = -1 }, -1, 16384, FLAGS },
+    { "tile", "set tile size for extended transitions, -1 rows, 0 auto", OFFSET(tile), AV_OPT_TYPE_INT, { .i64 = 0 }, -1, 4096, FLAGS },
+    { "resize", "set sampling of second input of different size", OFFSET(resize), AV_OPT_TYPE_INT, { .i64 = 2 }, 0, 2, FLAGS, .unit = "resize" },
+    {   "none",     "reject different sizes", 0, AV_OPT_TYPE_CONST, { .i64 = 0 }, 0, 0, FLAGS, .unit = "resize" },
+    {   "nearest",  "nearest neighbour",      0, AV_OPT_TYPE_CONST, { .i64 = 1 }, 0, 0, FLAGS, .unit = "resize" },
+    {   "bilinear", "bilinear",               0, AV_OPT_TYPE_CONST, { .i64 = 2 }, 0, 0, FLAGS, .unit = "resize" },
+    { "inputs", "set number of inputs, more than 2 for a slideshow", OFFSET(nb_inputs), AV_OPT_TYPE_INT, { .i64 = 2 }, 2, INT_MAX, FLAGS },
+    { "offsets", "set slideshow cut offsets, |-separated", OFFSET(offsets_str), AV_OPT_TYPE_STRING, {.str=NULL}, 0, 0, FLAGS },
+    { "durations", "set slideshow cut durations, |-separated", OFFSET(durations_str), AV_OPT_TYPE_STRING, {.str=NULL}, 0, 0, FLAGS },
+    { "transition", "set cross fade transition", OFFSET(transition_str), AV_OPT_TYPE_STRING, {.str=NULL}, 0, 0, TFLAGS, .unit = "transition" },
     {   "custom",    "custom transition",     0, AV_OPT_TYPE_CONST, {.i64=CUSTOM},    0, 0, FLAGS, .unit = "transition" },
     {   "fade",      "fade transition",       0, AV_OPT_TYPE_CONST, {.i64=FADE},      0, 0, FLAGS, .unit = "transition" },
     {   "wipeleft",  "wipe left transition",  0, AV_OPT_TYPE_CONST, {.i64=WIPELEFT},  0, 0, FLAGS, .unit = "transition" },
@@ -240,6 +314,11 @@ static const AVOption xfade_options[] = {
     { "duration", "set cross fade duration", OFFSET(duration), AV_OPT_TYPE_DURATION, {.i64=1000000}, 0, 60000000, FLAGS },
     { "offset",   "set cross fade start relative to first input stream", OFFSET(offset), AV_OPT_TYPE_DURATION, {.i64=0}, INT64_MIN, INT64_MAX, FLAGS },
     { "expr",   "set expression for custom transition", OFFSET(custom_str), AV_OPT_TYPE_STRING, {.str=NULL}, 0, 0, FLAGS },
+    { "mask", "evaluate custom expression once per pixel as an input weight", OFFSET(mask), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 2, FLAGS, .unit = "mask" },
+    {   "none", "expression output per plane", 0, AV_OPT_TYPE_CONST, { .i64 = 0 }, 0, 0, FLAGS, .unit = "mask" },
+    {   "b",    "second input weight",         0, AV_OPT_TYPE_CONST, { .i64 = 1 }, 0, 0, FLAGS, .unit = "mask" },
+    {   "a",    "first input weight",          0, AV_OPT_TYPE_CONST, { .i64 = 2 }, 0, 0, FLAGS, .unit = "mask" },
+    { "samples", "log easing curve at samples + 1 points as CSV", OFFSET(samples), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 100000, FLAGS },
     { NULL }
 };
 
@@ -254,11 +333,15 @@ static void custom##name##_transition(AVFilterContext *ctx,
     XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
+    AVExpr *e = s->e[jobnr];                                                         \
+    ExprData d = { .s = s, .xf = { a, b } };                                         \
                                                                                      \
     double values[VAR_VARS_NB];                                                      \
     values[VAR_W] = width;                                                           \
     values[VAR_H] = out->height;                                                     \
     values[VAR_PROGRESS] = progress;                                                 \
+    values[VAR_UNEASED] = s->progress[0];                                            \
+    values[VAR_EASED] = s->progress[1];                                              \
                                                                                      \
     for (int p = 0; p < s->nb_planes; p++) {                                         \
         const type *xf0 = (const type *)(a->data[p] + slice_start * a->linesize[p]); \
@@ -273,7 +356,7 @@ static void custom##name##_transition(AVFilterContext *ctx,
                 values[VAR_X] = x;                                                   \
                 values[VAR_A] = xf0[x];                                              \
                 values[VAR_B] = xf1[x];                                              \
-                dst[x] = av_expr_eval(s->e, values, s);                              \
+                dst[x] = av_expr_eval(e, values, &d);                                \
             }                                                                        \
                                                                                      \
             dst += out->linesize[p] / div;                                           \
@@ -305,13 +388,26 @@ static inline float smoothstep(float edge0, float edge1, float x)
     return t * t * (3.f - 2.f * t);
 }
 
+static void xe_kernel_transition(AVFilterContext *ctx, XFadeKernel kernel, const AVFrame *a, const AVFrame *b,
+                                 AVFrame *out, float progress, int slice_start, int slice_end, int jobnr);
+
+// built-in transition entry point, runs name##_kernel with the plane levels of ctx
+#define KERNEL_TRANSITION(name)                                                      \
+static void name##_transition(AVFilterContext *ctx,                                  \
+                              const AVFrame *a, const AVFrame *b, AVFrame *out,      \
+                              float progress,                                        \
+                              int slice_start, int slice_end, int jobnr)             \
+{                                                                                    \
+    xe_kernel_transition(ctx, name##_kernel, a, b, out, progress,                    \
+                         slice_start, slice_end, jobnr);                             \
+}
+
 #define FADE_TRANSITION(name, type, div)                                             \
-static void fade##name##_transition(AVFilterContext *ctx,                            \
+static void fade##name##_kernel(const XFadePlanes *s,                                \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
                                                                                      \
@@ -330,18 +426,19 @@ static void fade##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(fade##name)
 
 FADE_TRANSITION(8, uint8_t, 1)
 FADE_TRANSITION(16, uint16_t, 2)
+FADE_TRANSITION(32, float, 4)
 
 #define WIPELEFT_TRANSITION(name, type, div)                                         \
-static void wipeleft##name##_transition(AVFilterContext *ctx,                        \
+static void wipeleft##name##_kernel(const XFadePlanes *s,                            \
                                 const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                 float progress,                                      \
                                 int slice_start, int slice_end, int jobnr)           \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int z = width * progress;                                                  \
@@ -361,18 +458,19 @@ static void wipeleft##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(wipeleft##name)
 
 WIPELEFT_TRANSITION(8, uint8_t, 1)
 WIPELEFT_TRANSITION(16, uint16_t, 2)
+WIPELEFT_TRANSITION(32, float, 4)
 
 #define WIPERIGHT_TRANSITION(name, type, div)                                        \
-static void wiperight##name##_transition(AVFilterContext *ctx,                       \
+static void wiperight##name##_kernel(const XFadePlanes *s,                           \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,   \
                                  float progress,                                     \
                                  int slice_start, int slice_end, int jobnr)          \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int z = width * (1.f - progress);                                          \
@@ -392,18 +490,19 @@ static void wiperight##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(wiperight##name)
 
 WIPERIGHT_TRANSITION(8, uint8_t, 1)
 WIPERIGHT_TRANSITION(16, uint16_t, 2)
+WIPERIGHT_TRANSITION(32, float, 4)
 
 #define WIPEUP_TRANSITION(name, type, div)                                           \
-static void wipeup##name##_transition(AVFilterContext *ctx,                          \
+static void wipeup##name##_kernel(const XFadePlanes *s,                              \
                               const AVFrame *a, const AVFrame *b, AVFrame *out,      \
                               float progress,                                        \
                               int slice_start, int slice_end, int jobnr)             \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int z = out->height * progress;                                            \
@@ -423,18 +522,19 @@ static void wipeup##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(wipeup##name)
 
 WIPEUP_TRANSITION(8, uint8_t, 1)
 WIPEUP_TRANSITION(16, uint16_t, 2)
+WIPEUP_TRANSITION(32, float, 4)
 
 #define WIPEDOWN_TRANSITION(name, type, div)                                         \
-static void wipedown##name##_transition(AVFilterContext *ctx,                        \
+static void wipedown##name##_kernel(const XFadePlanes *s,                            \
                                 const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                 float progress,                                      \
                                 int slice_start, int slice_end, int jobnr)           \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int z = out->height * (1.f - progress);                                    \
@@ -454,18 +554,19 @@ static void wipedown##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(wipedown##name)
 
 WIPEDOWN_TRANSITION(8, uint8_t, 1)
 WIPEDOWN_TRANSITION(16, uint16_t, 2)
+WIPEDOWN_TRANSITION(32, float, 4)
 
 #define SLIDELEFT_TRANSITION(name, type, div)                                        \
-static void slideleft##name##_transition(AVFilterContext *ctx,                       \
+static void slideleft##name##_kernel(const XFadePlanes *s,                           \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,   \
                                  float progress,                                     \
                                  int slice_start, int slice_end, int jobnr)          \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int z = -progress * width;                                                 \
@@ -487,18 +588,19 @@ static void slideleft##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(slideleft##name)
 
 SLIDELEFT_TRANSITION(8, uint8_t, 1)
 SLIDELEFT_TRANSITION(16, uint16_t, 2)
+SLIDELEFT_TRANSITION(32, float, 4)
 
 #define SLIDERIGHT_TRANSITION(name, type, div)                                       \
-static void slideright##name##_transition(AVFilterContext *ctx,                      \
+static void slideright##name##_kernel(const XFadePlanes *s,                          \
                                   const AVFrame *a, const AVFrame *b, AVFrame *out,  \
                                   float progress,                                    \
                                   int slice_start, int slice_end, int jobnr)         \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int z = progress * width;                                                  \
@@ -520,18 +622,19 @@ static void slideright##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(slideright##name)
 
 SLIDERIGHT_TRANSITION(8, uint8_t, 1)
 SLIDERIGHT_TRANSITION(16, uint16_t, 2)
+SLIDERIGHT_TRANSITION(32, float, 4)
 
 #define SLIDEUP_TRANSITION(name, type, div)                                         \
-static void slideup##name##_transition(AVFilterContext *ctx,                        \
+static void slideup##name##_kernel(const XFadePlanes *s,                            \
                                const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                float progress,                                      \
                                int slice_start, int slice_end, int jobnr)           \
 {                                                                                   \
-    XFadeContext *s = ctx->priv;                                                    \
     const int height = out->height;                                                 \
     const int width = out->width;                                                   \
     const int z = -progress * height;                                               \
@@ -552,18 +655,19 @@ static void slideup##name##_transition(AVFilterContext *ctx,
             dst += out->linesize[p] / div;                                          \
         }                                                                           \
     }                                                                               \
-}
+}                                                                                   \
+KERNEL_TRANSITION(slideup##name)
 
 SLIDEUP_TRANSITION(8, uint8_t, 1)
 SLIDEUP_TRANSITION(16, uint16_t, 2)
+SLIDEUP_TRANSITION(32, float, 4)
 
 #define SLIDEDOWN_TRANSITION(name, type, div)                                       \
-static void slidedown##name##_transition(AVFilterContext *ctx,                      \
+static void slidedown##name##_kernel(const XFadePlanes *s,                          \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,  \
                                  float progress,                                    \
                                  int slice_start, int slice_end, int jobnr)         \
 {                                                                                   \
-    XFadeContext *s = ctx->priv;                                                    \
     const int height = out->height;                                                 \
     const int width = out->width;                                                   \
     const int z = progress * height;                                                \
@@ -584,18 +688,19 @@ static void slidedown##name##_transition(AVFilterContext *ctx,
             dst += out->linesize[p] / div;                                          \
         }                                                                           \
     }                                                                               \
-}
+}                                                                                   \
+KERNEL_TRANSITION(slidedown##name)
 
 SLIDEDOWN_TRANSITION(8, uint8_t, 1)
 SLIDEDOWN_TRANSITION(16, uint16_t, 2)
+SLIDEDOWN_TRANSITION(32, float, 4)
 
 #define CIRCLECROP_TRANSITION(name, type, div)                                      \
-static void circlecrop##name##_transition(AVFilterContext *ctx,                     \
+static void circlecrop##name##_kernel(const XFadePlanes *s,                         \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,  \
                                  float progress,                                    \
                                  int slice_start, int slice_end, int jobnr)         \
 {                                                                                   \
-    XFadeContext *s = ctx->priv;                                                    \
     const int width = out->width;                                                   \
     const int height = out->height;                                                 \
     float z = powf(2.f * fabsf(progress - 0.5f), 3.f) * hypotf(width/2, height/2);  \
@@ -617,18 +722,19 @@ static void circlecrop##name##_transition(AVFilterContext *ctx,
             dst += out->linesize[p] / div;                                          \
         }                                                                           \
     }                                                                               \
-}
+}                                                                                   \
+KERNEL_TRANSITION(circlecrop##name)
 
 CIRCLECROP_TRANSITION(8, uint8_t, 1)
 CIRCLECROP_TRANSITION(16, uint16_t, 2)
+CIRCLECROP_TRANSITION(32, float, 4)
 
 #define RECTCROP_TRANSITION(name, type, div)                                        \
-static void rectcrop##name##_transition(AVFilterContext *ctx,                       \
+static void rectcrop##name##_kernel(const XFadePlanes *s,                           \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,  \
                                  float progress,                                    \
                                  int slice_start, int slice_end, int jobnr)         \
 {                                                                                   \
-    XFadeContext *s = ctx->priv;                                                    \
     const int width = out->width;                                                   \
     const int height = out->height;                                                 \
     int zh = fabsf(progress - 0.5f) * height;                                       \
@@ -652,18 +758,19 @@ static void rectcrop##name##_transition(AVFilterContext *ctx,
             dst += out->linesize[p] / div;                                          \
         }                                                                           \
     }                                                                               \
-}
+}                                                                                   \
+KERNEL_TRANSITION(rectcrop##name)
 
 RECTCROP_TRANSITION(8, uint8_t, 1)
 RECTCROP_TRANSITION(16, uint16_t, 2)
+RECTCROP_TRANSITION(32, float, 4)
 
 #define DISTANCE_TRANSITION(name, type, div)                                        \
-static void distance##name##_transition(AVFilterContext *ctx,                       \
+static void distance##name##_kernel(const XFadePlanes *s,                           \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,  \
                                  float progress,                                    \
                                  int slice_start, int slice_end, int jobnr)         \
 {                                                                                   \
-    XFadeContext *s = ctx->priv;                                                    \
     const int width = out->width;                                                   \
     const float max = s->max_value;                                                 \
                                                                                     \
@@ -687,18 +794,19 @@ static void distance##name##_transition(AVFilterContext *ctx,
             }                                                                       \
         }                                                                           \
     }                                                                               \
-}
+}                                                                                   \
+KERNEL_TRANSITION(distance##name)
 
 DISTANCE_TRANSITION(8, uint8_t, 1)
 DISTANCE_TRANSITION(16, uint16_t, 2)
+DISTANCE_TRANSITION(32, float, 4)
 
 #define FADEBLACK_TRANSITION(name, type, div)                                        \
-static void fadeblack##name##_transition(AVFilterContext *ctx,                       \
+static void fadeblack##name##_kernel(const XFadePlanes *s,                           \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const float phase = 0.2f;                                                        \
@@ -721,18 +829,19 @@ static void fadeblack##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(fadeblack##name)
 
 FADEBLACK_TRANSITION(8, uint8_t, 1)
 FADEBLACK_TRANSITION(16, uint16_t, 2)
+FADEBLACK_TRANSITION(32, float, 4)
 
 #define FADEWHITE_TRANSITION(name, type, div)                                        \
-static void fadewhite##name##_transition(AVFilterContext *ctx,                       \
+static void fadewhite##name##_kernel(const XFadePlanes *s,                           \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const float phase = 0.2f;                                                        \
@@ -755,18 +864,19 @@ static void fadewhite##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(fadewhite##name)
 
 FADEWHITE_TRANSITION(8, uint8_t, 1)
 FADEWHITE_TRANSITION(16, uint16_t, 2)
+FADEWHITE_TRANSITION(32, float, 4)
 
 #define RADIAL_TRANSITION(name, type, div)                                           \
-static void radial##name##_transition(AVFilterContext *ctx,                          \
+static void radial##name##_kernel(const XFadePlanes *s,                              \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const int height = out->height;                                                  \
                                                                                      \
@@ -783,18 +893,19 @@ static void radial##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(radial##name)
 
 RADIAL_TRANSITION(8, uint8_t, 1)
 RADIAL_TRANSITION(16, uint16_t, 2)
+RADIAL_TRANSITION(32, float, 4)
 
 #define SMOOTHLEFT_TRANSITION(name, type, div)                                       \
-static void smoothleft##name##_transition(AVFilterContext *ctx,                      \
+static void smoothleft##name##_kernel(const XFadePlanes *s,                          \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
                                                                                      \
@@ -811,18 +922,19 @@ static void smoothleft##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(smoothleft##name)
 
 SMOOTHLEFT_TRANSITION(8, uint8_t, 1)
 SMOOTHLEFT_TRANSITION(16, uint16_t, 2)
+SMOOTHLEFT_TRANSITION(32, float, 4)
 
 #define SMOOTHRIGHT_TRANSITION(name, type, div)                                      \
-static void smoothright##name##_transition(AVFilterContext *ctx,                     \
+static void smoothright##name##_kernel(const XFadePlanes *s,                         \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
                                                                                      \
@@ -839,18 +951,19 @@ static void smoothright##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(smoothright##name)
 
 SMOOTHRIGHT_TRANSITION(8, uint8_t, 1)
 SMOOTHRIGHT_TRANSITION(16, uint16_t, 2)
+SMOOTHRIGHT_TRANSITION(32, float, 4)
 
 #define SMOOTHUP_TRANSITION(name, type, div)                                         \
-static void smoothup##name##_transition(AVFilterContext *ctx,                        \
+static void smoothup##name##_kernel(const XFadePlanes *s,                            \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const float h = out->height;                                                     \
                                                                                      \
@@ -866,18 +979,19 @@ static void smoothup##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(smoothup##name)
 
 SMOOTHUP_TRANSITION(8, uint8_t, 1)
 SMOOTHUP_TRANSITION(16, uint16_t, 2)
+SMOOTHUP_TRANSITION(32, float, 4)
 
 #define SMOOTHDOWN_TRANSITION(name, type, div)                                       \
-static void smoothdown##name##_transition(AVFilterContext *ctx,                      \
+static void smoothdown##name##_kernel(const XFadePlanes *s,                          \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const float h = out->height;                                                     \
                                                                                      \
@@ -893,18 +1007,19 @@ static void smoothdown##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(smoothdown##name)
 
 SMOOTHDOWN_TRANSITION(8, uint8_t, 1)
 SMOOTHDOWN_TRANSITION(16, uint16_t, 2)
+SMOOTHDOWN_TRANSITION(32, float, 4)
 
 #define CIRCLEOPEN_TRANSITION(name, type, div)                                       \
-static void circleopen##name##_transition(AVFilterContext *ctx,                      \
+static void circleopen##name##_kernel(const XFadePlanes *s,                          \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const int height = out->height;                                                  \
     const float z = hypotf(width / 2, height / 2);                                   \
@@ -922,18 +1037,19 @@ static void circleopen##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(circleopen##name)
 
 CIRCLEOPEN_TRANSITION(8, uint8_t, 1)
 CIRCLEOPEN_TRANSITION(16, uint16_t, 2)
+CIRCLEOPEN_TRANSITION(32, float, 4)
 
 #define CIRCLECLOSE_TRANSITION(name, type, div)                                      \
-static void circleclose##name##_transition(AVFilterContext *ctx,                     \
+static void circleclose##name##_kernel(const XFadePlanes *s,                         \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const int height = out->height;                                                  \
     const float z = hypotf(width / 2, height / 2);                                   \
@@ -951,18 +1067,19 @@ static void circleclose##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(circleclose##name)
 
 CIRCLECLOSE_TRANSITION(8, uint8_t, 1)
 CIRCLECLOSE_TRANSITION(16, uint16_t, 2)
+CIRCLECLOSE_TRANSITION(32, float, 4)
 
 #define VERTOPEN_TRANSITION(name, type, div)                                         \
-static void vertopen##name##_transition(AVFilterContext *ctx,                        \
+static void vertopen##name##_kernel(const XFadePlanes *s,                            \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const float w2 = out->width / 2.0;                                                 \
                                                                                      \
@@ -978,18 +1095,19 @@ static void vertopen##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(vertopen##name)
 
 VERTOPEN_TRANSITION(8, uint8_t, 1)
 VERTOPEN_TRANSITION(16, uint16_t, 2)
+VERTOPEN_TRANSITION(32, float, 4)
 
 #define VERTCLOSE_TRANSITION(name, type, div)                                        \
-static void vertclose##name##_transition(AVFilterContext *ctx,                       \
+static void vertclose##name##_kernel(const XFadePlanes *s,                           \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float w2 = out->width / 2.0;                                                 \
@@ -1006,18 +1124,19 @@ static void vertclose##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(vertclose##name)
 
 VERTCLOSE_TRANSITION(8, uint8_t, 1)
 VERTCLOSE_TRANSITION(16, uint16_t, 2)
+VERTCLOSE_TRANSITION(32, float, 4)
 
 #define HORZOPEN_TRANSITION(name, type, div)                                         \
-static void horzopen##name##_transition(AVFilterContext *ctx,                        \
+static void horzopen##name##_kernel(const XFadePlanes *s,                            \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float h2 = out->height / 2.0;                                                \
@@ -1034,18 +1153,19 @@ static void horzopen##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(horzopen##name)
 
 HORZOPEN_TRANSITION(8, uint8_t, 1)
 HORZOPEN_TRANSITION(16, uint16_t, 2)
+HORZOPEN_TRANSITION(32, float, 4)
 
 #define HORZCLOSE_TRANSITION(name, type, div)                                        \
-static void horzclose##name##_transition(AVFilterContext *ctx,                       \
+static void horzclose##name##_kernel(const XFadePlanes *s,                           \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float h2 = out->height / 2.0;                                                \
@@ -1062,10 +1182,12 @@ static void horzclose##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(horzclose##name)
 
 HORZCLOSE_TRANSITION(8, uint8_t, 1)
 HORZCLOSE_TRANSITION(16, uint16_t, 2)
+HORZCLOSE_TRANSITION(32, float, 4)
 
 static float frand(int x, int y)
 {
@@ -1075,12 +1197,11 @@ static float frand(int x, int y)
 }
 
 #define DISSOLVE_TRANSITION(name, type, div)                                         \
-static void dissolve##name##_transition(AVFilterContext *ctx,                        \
+static void dissolve##name##_kernel(const XFadePlanes *s,                            \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
                                                                                      \
@@ -1096,18 +1217,19 @@ static void dissolve##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(dissolve##name)
 
 DISSOLVE_TRANSITION(8, uint8_t, 1)
 DISSOLVE_TRANSITION(16, uint16_t, 2)
+DISSOLVE_TRANSITION(32, float, 4)
 
 #define PIXELIZE_TRANSITION(name, type, div)                                         \
-static void pixelize##name##_transition(AVFilterContext *ctx,                        \
+static void pixelize##name##_kernel(const XFadePlanes *s,                            \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int w = out->width;                                                        \
     const int h = out->height;                                                       \
@@ -1129,18 +1251,19 @@ static void pixelize##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(pixelize##name)
 
 PIXELIZE_TRANSITION(8, uint8_t, 1)
 PIXELIZE_TRANSITION(16, uint16_t, 2)
+PIXELIZE_TRANSITION(32, float, 4)
 
 #define DIAGTL_TRANSITION(name, type, div)                                           \
-static void diagtl##name##_transition(AVFilterContext *ctx,                          \
+static void diagtl##name##_kernel(const XFadePlanes *s,                              \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
@@ -1159,18 +1282,19 @@ static void diagtl##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(diagtl##name)
 
 DIAGTL_TRANSITION(8, uint8_t, 1)
 DIAGTL_TRANSITION(16, uint16_t, 2)
+DIAGTL_TRANSITION(32, float, 4)
 
 #define DIAGTR_TRANSITION(name, type, div)                                           \
-static void diagtr##name##_transition(AVFilterContext *ctx,                          \
+static void diagtr##name##_kernel(const XFadePlanes *s,                              \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
@@ -1189,18 +1313,19 @@ static void diagtr##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(diagtr##name)
 
 DIAGTR_TRANSITION(8, uint8_t, 1)
 DIAGTR_TRANSITION(16, uint16_t, 2)
+DIAGTR_TRANSITION(32, float, 4)
 
 #define DIAGBL_TRANSITION(name, type, div)                                           \
-static void diagbl##name##_transition(AVFilterContext *ctx,                          \
+static void diagbl##name##_kernel(const XFadePlanes *s,                              \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
@@ -1219,18 +1344,19 @@ static void diagbl##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(diagbl##name)
 
 DIAGBL_TRANSITION(8, uint8_t, 1)
 DIAGBL_TRANSITION(16, uint16_t, 2)
+DIAGBL_TRANSITION(32, float, 4)
 
 #define DIAGBR_TRANSITION(name, type, div)                                           \
-static void diagbr##name##_transition(AVFilterContext *ctx,                          \
+static void diagbr##name##_kernel(const XFadePlanes *s,                              \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
@@ -1250,18 +1376,19 @@ static void diagbr##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(diagbr##name)
 
 DIAGBR_TRANSITION(8, uint8_t, 1)
 DIAGBR_TRANSITION(16, uint16_t, 2)
+DIAGBR_TRANSITION(32, float, 4)
 
 #define HLSLICE_TRANSITION(name, type, div)                                          \
-static void hlslice##name##_transition(AVFilterContext *ctx,                         \
+static void hlslice##name##_kernel(const XFadePlanes *s,                             \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
@@ -1280,18 +1407,19 @@ static void hlslice##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(hlslice##name)
 
 HLSLICE_TRANSITION(8, uint8_t, 1)
 HLSLICE_TRANSITION(16, uint16_t, 2)
+HLSLICE_TRANSITION(32, float, 4)
 
 #define HRSLICE_TRANSITION(name, type, div)                                          \
-static void hrslice##name##_transition(AVFilterContext *ctx,                         \
+static void hrslice##name##_kernel(const XFadePlanes *s,                             \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
@@ -1311,18 +1439,19 @@ static void hrslice##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(hrslice##name)
 
 HRSLICE_TRANSITION(8, uint8_t, 1)
 HRSLICE_TRANSITION(16, uint16_t, 2)
+HRSLICE_TRANSITION(32, float, 4)
 
 #define VUSLICE_TRANSITION(name, type, div)                                          \
-static void vuslice##name##_transition(AVFilterContext *ctx,                         \
+static void vuslice##name##_kernel(const XFadePlanes *s,                             \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float h = out->height;                                                     \
@@ -1341,18 +1470,19 @@ static void vuslice##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(vuslice##name)
 
 VUSLICE_TRANSITION(8, uint8_t, 1)
 VUSLICE_TRANSITION(16, uint16_t, 2)
+VUSLICE_TRANSITION(32, float, 4)
 
 #define VDSLICE_TRANSITION(name, type, div)                                          \
-static void vdslice##name##_transition(AVFilterContext *ctx,                         \
+static void vdslice##name##_kernel(const XFadePlanes *s,                             \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float h = out->height;                                                     \
@@ -1372,18 +1502,19 @@ static void vdslice##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(vdslice##name)
 
 VDSLICE_TRANSITION(8, uint8_t, 1)
 VDSLICE_TRANSITION(16, uint16_t, 2)
+VDSLICE_TRANSITION(32, float, 4)
 
 #define HBLUR_TRANSITION(name, type, div)                                            \
-static void hblur##name##_transition(AVFilterContext *ctx,                           \
+static void hblur##name##_kernel(const XFadePlanes *s,                               \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int nb_planes = s->nb_planes;                                              \
     const int width = out->width;                                                    \
     const float prog = progress <= 0.5f ? progress * 2.f : (1.f - progress) * 2.f;   \
@@ -1417,18 +1548,19 @@ static void hblur##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(hblur##name)
 
 HBLUR_TRANSITION(8, uint8_t, 1)
 HBLUR_TRANSITION(16, uint16_t, 2)
+HBLUR_TRANSITION(32, float, 4)
 
 #define FADEGRAYS_TRANSITION(name, type, div)                                        \
-static void fadegrays##name##_transition(AVFilterContext *ctx,                       \
+static void fadegrays##name##_kernel(const XFadePlanes *s,                           \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const int is_rgb = s->is_rgb;                                                    \
     const int mid = (s->max_value + 1) / 2;                                          \
@@ -1487,18 +1619,18 @@ static void fadegrays##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(fadegrays##name)
 
 FADEGRAYS_TRANSITION(8, uint8_t, 1)
 FADEGRAYS_TRANSITION(16, uint16_t, 2)
 
 #define WIPETL_TRANSITION(name, type, div)                                           \
-static void wipetl##name##_transition(AVFilterContext *ctx,                          \
+static void wipetl##name##_kernel(const XFadePlanes *s,                              \
                                 const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                 float progress,                                      \
                                 int slice_start, int slice_end, int jobnr)           \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int zw = out->width * progress;                                            \
@@ -1520,18 +1652,19 @@ static void wipetl##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(wipetl##name)
 
 WIPETL_TRANSITION(8, uint8_t, 1)
 WIPETL_TRANSITION(16, uint16_t, 2)
+WIPETL_TRANSITION(32, float, 4)
 
 #define WIPETR_TRANSITION(name, type, div)                                           \
-static void wipetr##name##_transition(AVFilterContext *ctx,                          \
+static void wipetr##name##_kernel(const XFadePlanes *s,                              \
                                 const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                 float progress,                                      \
                                 int slice_start, int slice_end, int jobnr)           \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int zw = width * (1.f - progress);                                         \
@@ -1553,18 +1686,19 @@ static void wipetr##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(wipetr##name)
 
 WIPETR_TRANSITION(8, uint8_t, 1)
 WIPETR_TRANSITION(16, uint16_t, 2)
+WIPETR_TRANSITION(32, float, 4)
 
 #define WIPEBL_TRANSITION(name, type, div)                                           \
-static void wipebl##name##_transition(AVFilterContext *ctx,                          \
+static void wipebl##name##_kernel(const XFadePlanes *s,                              \
                                 const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                 float progress,                                      \
                                 int slice_start, int slice_end, int jobnr)           \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int zw = width * progress;                                                 \
@@ -1586,18 +1720,19 @@ static void wipebl##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(wipebl##name)
 
 WIPEBL_TRANSITION(8, uint8_t, 1)
 WIPEBL_TRANSITION(16, uint16_t, 2)
+WIPEBL_TRANSITION(32, float, 4)
 
 #define WIPEBR_TRANSITION(name, type, div)                                           \
-static void wipebr##name##_transition(AVFilterContext *ctx,                          \
+static void wipebr##name##_kernel(const XFadePlanes *s,                              \
                                 const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                 float progress,                                      \
                                 int slice_start, int slice_end, int jobnr)           \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int zh = out->height * (1.f - progress);                                   \
     const int width = out->width;                                                    \
@@ -1619,18 +1754,19 @@ static void wipebr##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(wipebr##name)
 
 WIPEBR_TRANSITION(8, uint8_t, 1)
 WIPEBR_TRANSITION(16, uint16_t, 2)
+WIPEBR_TRANSITION(32, float, 4)
 
 #define SQUEEZEH_TRANSITION(name, type, div)                                         \
-static void squeezeh##name##_transition(AVFilterContext *ctx,                        \
+static void squeezeh##name##_kernel(const XFadePlanes *s,                            \
                                 const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                 float progress,                                      \
                                 int slice_start, int slice_end, int jobnr)           \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const float h = out->height;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
@@ -1657,18 +1793,19 @@ static void squeezeh##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(squeezeh##name)
 
 SQUEEZEH_TRANSITION(8, uint8_t, 1)
 SQUEEZEH_TRANSITION(16, uint16_t, 2)
+SQUEEZEH_TRANSITION(32, float, 4)
 
 #define SQUEEZEV_TRANSITION(name, type, div)                                         \
-static void squeezev##name##_transition(AVFilterContext *ctx,                        \
+static void squeezev##name##_kernel(const XFadePlanes *s,                            \
                                 const AVFrame *a, const AVFrame *b, AVFrame *out,    \
                                 float progress,                                      \
                                 int slice_start, int slice_end, int jobnr)           \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
     const int height = slice_end - slice_start;                                      \
@@ -1696,10 +1833,12 @@ static void squeezev##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(squeezev##name)
 
 SQUEEZEV_TRANSITION(8, uint8_t, 1)
 SQUEEZEV_TRANSITION(16, uint16_t, 2)
+SQUEEZEV_TRANSITION(32, float, 4)
 
 static void zoom(float *u, float *v, float amount)
 {
@@ -1708,12 +1847,11 @@ static void zoom(float *u, float *v, float amount)
 }
 
 #define ZOOMIN_TRANSITION(name, type, div)                                           \
-static void zoomin##name##_transition(AVFilterContext *ctx,                          \
+static void zoomin##name##_kernel(const XFadePlanes *s,                              \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
     const float w = width;                                                           \
     const float h = out->height;                                                     \
@@ -1741,18 +1879,19 @@ static void zoomin##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(zoomin##name)
 
 ZOOMIN_TRANSITION(8, uint8_t, 1)
 ZOOMIN_TRANSITION(16, uint16_t, 2)
+ZOOMIN_TRANSITION(32, float, 4)
 
 #define FADEFAST_TRANSITION(name, type, div)                                         \
-static void fadefast##name##_transition(AVFilterContext *ctx,                        \
+static void fadefast##name##_kernel(const XFadePlanes *s,                            \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const float imax = 1.f / s->max_value;                                           \
@@ -1774,18 +1913,19 @@ static void fadefast##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(fadefast##name)
 
 FADEFAST_TRANSITION(8, uint8_t, 1)
 FADEFAST_TRANSITION(16, uint16_t, 2)
+FADEFAST_TRANSITION(32, float, 4)
 
 #define FADESLOW_TRANSITION(name, type, div)                                         \
-static void fadeslow##name##_transition(AVFilterContext *ctx,                        \
+static void fadeslow##name##_kernel(const XFadePlanes *s,                            \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const float imax = 1.f / s->max_value;                                           \
@@ -1807,18 +1947,19 @@ static void fadeslow##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(fadeslow##name)
 
 FADESLOW_TRANSITION(8, uint8_t, 1)
 FADESLOW_TRANSITION(16, uint16_t, 2)
+FADESLOW_TRANSITION(32, float, 4)
 
 #define HWIND_TRANSITION(name, z, type, div, expr)                                   \
-static void h##z##wind##name##_transition(AVFilterContext *ctx,                      \
+static void h##z##wind##name##_kernel(const XFadePlanes *s,                          \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
                                                                                      \
     for (int y = slice_start; y < slice_end; y++) {                                  \
@@ -1836,20 +1977,22 @@ static void h##z##wind##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(h##z##wind##name)
 
 HWIND_TRANSITION(8,  l, uint8_t,  1, 1.f - )
 HWIND_TRANSITION(16, l, uint16_t, 2, 1.f - )
+HWIND_TRANSITION(32, l, float, 4, 1.f - )
 HWIND_TRANSITION(8,  r, uint8_t,  1, )
 HWIND_TRANSITION(16, r, uint16_t, 2, )
+HWIND_TRANSITION(32, r, float, 4, )
 
 #define VWIND_TRANSITION(name, z, type, div, expr)                                   \
-static void v##z##wind##name##_transition(AVFilterContext *ctx,                      \
+static void v##z##wind##name##_kernel(const XFadePlanes *s,                          \
                             const AVFrame *a, const AVFrame *b, AVFrame *out,        \
                             float progress,                                          \
                             int slice_start, int slice_end, int jobnr)               \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int width = out->width;                                                    \
                                                                                      \
     for (int y = slice_start; y < slice_end; y++) {                                  \
@@ -1867,20 +2010,22 @@ static void v##z##wind##name##_transition(AVFilterContext *ctx,
             }                                                                        \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(v##z##wind##name)
 
 VWIND_TRANSITION(8,  u, uint8_t,  1, 1.f - )
 VWIND_TRANSITION(16, u, uint16_t, 2, 1.f - )
+VWIND_TRANSITION(32, u, float, 4, 1.f - )
 VWIND_TRANSITION(8,  d, uint8_t,  1, )
 VWIND_TRANSITION(16, d, uint16_t, 2, )
+VWIND_TRANSITION(32, d, float, 4, )
 
 #define COVERH_TRANSITION(dir, name, type, div, expr)                                \
-static void cover##dir##name##_transition(AVFilterContext *ctx,                      \
+static void cover##dir##name##_kernel(const XFadePlanes *s,                          \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,   \
                                  float progress,                                     \
                                  int slice_start, int slice_end, int jobnr)          \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int z = (expr progress) * width;                                           \
@@ -1902,20 +2047,22 @@ static void cover##dir##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(cover##dir##name)
 
 COVERH_TRANSITION(left,   8, uint8_t,  1, -)
 COVERH_TRANSITION(left,  16, uint16_t, 2, -)
+COVERH_TRANSITION(left,  32, float, 4, -)
 COVERH_TRANSITION(right,  8, uint8_t,  1, )
 COVERH_TRANSITION(right, 16, uint16_t, 2, )
+COVERH_TRANSITION(right, 32, float, 4, )
 
 #define COVERV_TRANSITION(dir, name, type, div, expr)                               \
-static void cover##dir##name##_transition(AVFilterContext *ctx,                     \
+static void cover##dir##name##_kernel(const XFadePlanes *s,                         \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,  \
                                  float progress,                                    \
                                  int slice_start, int slice_end, int jobnr)         \
 {                                                                                   \
-    XFadeContext *s = ctx->priv;                                                    \
     const int height = out->height;                                                 \
     const int width = out->width;                                                   \
     const int z = (expr progress) * height;                                         \
@@ -1935,20 +2082,22 @@ static void cover##dir##name##_transition(AVFilterContext *ctx,
             dst += out->linesize[p] / div;                                          \
         }                                                                           \
     }                                                                               \
-}
+}                                                                                   \
+KERNEL_TRANSITION(cover##dir##name)
 
 COVERV_TRANSITION(up,    8, uint8_t,  1, -)
 COVERV_TRANSITION(up,   16, uint16_t, 2, -)
+COVERV_TRANSITION(up,   32, float, 4, -)
 COVERV_TRANSITION(down,  8, uint8_t,  1, )
 COVERV_TRANSITION(down, 16, uint16_t, 2, )
+COVERV_TRANSITION(down, 32, float, 4, )
 
 #define REVEALH_TRANSITION(dir, name, type, div, expr)                               \
-static void reveal##dir##name##_transition(AVFilterContext *ctx,                     \
+static void reveal##dir##name##_kernel(const XFadePlanes *s,                         \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,   \
                                  float progress,                                     \
                                  int slice_start, int slice_end, int jobnr)          \
 {                                                                                    \
-    XFadeContext *s = ctx->priv;                                                     \
     const int height = slice_end - slice_start;                                      \
     const int width = out->width;                                                    \
     const int z = (expr progress) * width;                                           \
@@ -1970,20 +2119,22 @@ static void reveal##dir##name##_transition(AVFilterContext *ctx,
             xf1 += b->linesize[p] / div;                                             \
         }                                                                            \
     }                                                                                \
-}
+}                                                                                    \
+KERNEL_TRANSITION(reveal##dir##name)
 
 REVEALH_TRANSITION(left,   8, uint8_t,  1, -)
 REVEALH_TRANSITION(left,  16, uint16_t, 2, -)
+REVEALH_TRANSITION(left,  32, float, 4, -)
 REVEALH_TRANSITION(right,  8, uint8_t,  1, )
 REVEALH_TRANSITION(right, 16, uint16_t, 2, )
+REVEALH_TRANSITION(right, 32, float, 4, )
 
 #define REVEALV_TRANSITION(dir, name, type, div, expr)                              \
-static void reveal##dir##name##_transition(AVFilterContext *ctx,                    \
+static void reveal##dir##name##_kernel(const XFadePlanes *s,                        \
                                  const AVFrame *a, const AVFrame *b, AVFrame *out,  \
                                  float progress,                                    \
                                  int slice_start, int slice_end, int jobnr)         \
 {                                                                                   \
-    XFadeContext *s = ctx->priv;                                                    \
     const int height = out->height;                                                 \
     const int width = out->width;                                                   \
     const int z = (expr progress) * height;                                         \
@@ -2003,19 +2154,23 @@ static void reveal##dir##name##_transition(AVFilterContext *ctx,
             dst += out->linesize[p] / div;                                          \
         }                                                                           \
     }                                                                               \
-}
+}                                                                                   \
+KERNEL_TRANSITION(reveal##dir##name)
 
 REVEALV_TRANSITION(up,    8, uint8_t,  1, -)
 REVEALV_TRANSITION(up,   16, uint16_t, 2, -)
+REVEALV_TRANSITION(up,   32, float, 4, -)
 REVEALV_TRANSITION(down,  8, uint8_t,  1, )
 REVEALV_TRANSITION(down, 16, uint16_t, 2, )
+REVEALV_TRANSITION(down, 32, float, 4, )
 
 #include "xfade-easing.h" // easing & extended transitions
 
 static inline double getpix(void *priv, double x, double y, int plane, int nb)
 {
-    XFadeContext *s = priv;
-    AVFrame *in = s->xf[nb];
+    const ExprData *d = priv;
+    const XFadeContext *s = d->s;
+    const AVFrame *in = d->xf[nb];
     const uint8_t *src = in->data[FFMIN(plane, s->nb_planes - 1)];
     int linesize = in->linesize[FFMIN(plane, s->nb_planes - 1)];
     const int w = in->width;
@@ -2046,6 +2201,38 @@ static double b1(void *priv, double x, double y) { return getpix(priv, x, y, 1,
 static double b2(void *priv, double x, double y) { return getpix(priv, x, y, 2, 1); }
 static double b3(void *priv, double x, double y) { return getpix(priv, x, y, 3, 1); }
 
+static int query_formats(const AVFilterContext *ctx,
+                         AVFilterFormatsConfig **cfg_in,
+                         AVFilterFormatsConfig **cfg_out)
+{
+    const XFadeContext *s = ctx->priv;
+    int ret;
+
+    for (int j = 0; j < ctx->nb_inputs; j++) { // each input may differ from the first, converted
+        AVFilterFormats *formats = ff_make_pixel_format_list(pix_fmts);
+
+        if (!xe_full_chroma(s)) { // chroma subsampled and float formats too
+            for (int i = 0; subsampled_pix_fmts[i] != AV_PIX_FMT_NONE; i++)
+                if ((ret = ff_add_format(&formats, subsampled_pix_fmts[i])) < 0)
+                    return ret;
+            for (int i = 0; float_pix_fmts[i] != AV_PIX_FMT_NONE; i++)
+                if ((ret = ff_add_format(&formats, float_pix_fmts[i])) < 0)
+                    return ret;
+        }
+
+        if (!xe_xfade_transition(s)) // packed RGB too for extended transitions
+            for (int i = 0; packed_pix_fmts[i] != AV_PIX_FMT_NONE; i++)
+                if ((ret = ff_add_format(&formats, packed_pix_fmts[i])) < 0)
+                    return ret;
+
+        if (!j && (ret = ff_formats_ref(formats, &cfg_out[0]->formats)) < 0) // output as first input
+            return ret;
+        if ((ret = ff_formats_ref(formats, &cfg_in[j]->formats)) < 0)
+            return ret;
+    }
+    return 0;
+}
+
 static int config_output(AVFilterLink *outlink)
 {
     AVFilterContext *ctx = outlink->src;
@@ -2057,7 +2244,10 @@ static int config_output(AVFilterLink *outlink)
     XFadeContext *s = ctx->priv;
     const AVPixFmtDescriptor *pix_desc = av_pix_fmt_desc_get(inlink0->format);
 
-    if (inlink0->w != inlink1->w || inlink0->h != inlink1->h) {
+    if (ctx->nb_inputs > 2 && !s->show)
+        return xe_config_slideshow(outlink); // configures each cut here
+
+    if ((inlink0->w != inlink1->w || inlink0->h != inlink1->h) && !s->resize) {
         av_log(ctx, AV_LOG_ERROR, "First input link %s parameters "
                "(size %dx%d) do not match the corresponding "
                "second input link %s parameters (size %dx%d)\n",
@@ -2101,7 +2291,7 @@ static int config_output(AVFilterLink *outlink)
     s->depth = pix_desc->comp[0].depth;
     s->is_rgb = !!(pix_desc->flags & AV_PIX_FMT_FLAG_RGB);
     s->nb_planes = av_pix_fmt_count_planes(inlink0->format);
-    s->max_value = (1 << s->depth) - 1;
+    s->max_value = pix_desc->flags & AV_PIX_FMT_FLAG_FLOAT ? 1 : (1 << s->depth) - 1; // float is normalised
     s->black[0] = 0;
     s->black[1] = s->black[2] = s->is_rgb ? 0 : s->max_value / 2;
     s->black[3] = s->max_value;
@@ -2183,23 +2373,40 @@ static int config_output(AVFilterLink *outlink)
         static const char *const func2_names[]    = {
             "a0", "a1", "a2", "a3",
             "b0", "b1", "b2", "b3",
+            "ease_steps",
             NULL
         };
         double (*func2[])(void *, double, double) = {
             a0, a1, a2, a3,
             b0, b1, b2, b3,
+            xe_ease_steps,
             NULL };
-        int ret;
+        const int nb_jobs = ff_filter_get_nb_threads(ctx);
+        char *expr;
+        int ret = 0;
 
         if (!s->custom_str)
             return AVERROR(EINVAL);
-        ret = av_expr_parse(&s->e, s->custom_str, var_names,
-                            NULL, NULL, func2_names, func2, 0, ctx);
+        // with easing, ld(0) and ld(1) start as uneased and eased progress, as before variables PU and PE
+        expr = s->easing_str ? av_asprintf("st(0,PU);st(1,PE);%s", s->custom_str) : s->custom_str;
+        if (!expr)
+            return AVERROR(ENOMEM);
+        ret = xe_compile_expr(ctx, expr, xe_ease_func1_names, xe_ease_func1,
+                              func2_names, func2); // 1 if compiled, else evaluated per job
+        if (!ret && !(s->e = av_calloc(nb_jobs + 1, sizeof(*s->e))))
+            ret = AVERROR(ENOMEM);
+        for (int i = 0; !ret && i < nb_jobs; i++)
+            ret = av_expr_parse(&s->e[i], expr, var_names,
+                                xe_ease_func1_names, xe_ease_func1, func2_names, func2, 0, ctx);
+        if (expr != s->custom_str)
+            av_free(expr);
         if (ret < 0)
             return ret;
+        if (s->mask)
+            s->transitionf = s->depth <= 8 ? xe_mask8_transition : xe_mask16_transition;
     }
 
-    return 0;
+    return config_xfade_planes(ctx); // chroma subsampling
 }
 
 static int xfade_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
@@ -2219,27 +2426,33 @@ static int xfade_frame(AVFilterContext *ctx, AVFrame *a, AVFrame *b)
 {
     XFadeContext *s = ctx->priv;
     AVFilterLink *outlink = ctx->outputs[0];
-    float progress = av_clipf(1.f - ((float)(s->pts - s->start_pts) / s->duration_pts), 0.f, 1.f);
     ThreadData td;
     AVFrame *out;
 
-    out = ff_get_video_buffer(outlink, outlink->w, outlink->h);
+    xe_thread_data(s, a, b, &td); // eased progress
+    out = xe_endpoint_frame(ctx, &td); // an input unchanged
     if (!out)
-        return AVERROR(ENOMEM);
-    av_frame_copy_props(out, a);
-
-    progress = (s->reverse & REVERSE_EASING) ? 1 - ease(s, 1 - progress) : ease(s, progress); // eased progress
-    int i = s->reverse & REVERSE_TRANSITION;
-    if (i) progress = 1 - progress;
-    if (s->reverse & REVERSE_OVERSHOOT) { // internal flag
-        if (progress < 0) progress += 1, i ^= 1; // undershoot
-        else if (progress > 1) progress -= 1, i ^= 1; // overshoot
+        out = xe_reuse_frame(s, &td); // unchanged since last render
+    if (!out) {
+        out = xe_inplace_frame(s, &td, b); // over second input, for pointwise transitions
+        if (!out)
+            out = ff_get_video_buffer(outlink, outlink->w, outlink->h);
+        if (!out)
+            return AVERROR(ENOMEM);
+        td.out = out;
+        if (!xe_render_dirty(ctx, &td) && !xe_render_chunks(ctx, &td)) // still inputs, dynamic slices
+            ff_filter_execute(ctx, xfade_slice, &td, NULL,
+                              FFMIN(outlink->h, ff_filter_get_nb_threads(ctx)));
+        int ret = xe_cache_frame(s, &td);
+        if (ret < 0) {
+            av_frame_free(&out);
+            return ret;
+        }
     }
-    td.xf[i] = a, td.xf[i ^ 1] = b, td.out = out, td.progress = av_clipf(progress, 0, 1);
-    ff_filter_execute(ctx, xfade_slice, &td, NULL,
-                      FFMIN(outlink->h, ff_filter_get_nb_threads(ctx)));
+    av_frame_copy_props(out, a);
 
     out->pts = s->pts;
+    xe_frame_metadata(out, &td);
 
     return ff_filter_frame(outlink, out);
 }
@@ -2262,7 +2475,10 @@ static int forward_frame(XFadeContext *s,
             s->inputs_offset_pts = -frame->pts;
 
         // We got a frame, nothing to do other than adjusting the timestamp
+        if ((ret = xe_convert_frame(inlink->dst, &frame)) < 0)
+            return ret;
         frame->pts += s->inputs_offset_pts;
+        xe_passthrough_metadata(s, frame, 1);
         return ff_filter_frame(outlink, frame);
     }
 
@@ -2290,8 +2506,14 @@ static int xfade_activate(AVFilterContext *avctx)
     AVFilterLink *outlink = avctx->outputs[0];
     int64_t status_pts;
 
+    if (s->show)
+        return xe_slideshow_activate(avctx); // more than 2 inputs
+
     FF_FILTER_FORWARD_STATUS_BACK_ALL(outlink, avctx);
 
+    if (xe_batch_pending(s))
+        return xe_batch_frames(avctx); // held frames first
+
     // Check if we already transitioned or first input ended prematurely,
     // in which case just forward the frames from second input with adjusted
     // timestamps until EOF.
@@ -2316,6 +2538,7 @@ static int xfade_activate(AVFilterContext *avctx)
             ret = ff_inlink_consume_frame(in_a, &s->xf[0]);
             if (ret < 0)
                 return ret;
+            xe_passthrough_metadata(s, s->xf[0], 0);
             return ff_filter_frame(outlink, s->xf[0]);
         }
         s->passthrough = 0;
@@ -2323,10 +2546,14 @@ static int xfade_activate(AVFilterContext *avctx)
         // We are transitioning, so we need a frame from second input
         if (ff_inlink_check_available_frame(in_b)) {
             int ret;
+            if (xe_batchable(s))
+                return xe_batch_frames(avctx); // several frames at once
             ret = ff_inlink_consume_frame(avctx->inputs[0], &s->xf[0]);
             if (ret < 0)
                 return ret;
             ret = ff_inlink_consume_frame(avctx->inputs[1], &s->xf[1]);
+            if (ret >= 0)
+                ret = xe_convert_frame(avctx, &s->xf[1]); // to output format and size
             if (ret < 0) {
                 av_frame_free(&s->xf[0]);
                 return ret;
@@ -2403,6 +2630,23 @@ static const AVFilterPad xfade_inputs[] = {
     },
 };
 
+static av_cold int init(AVFilterContext *ctx)
+{
+    XFadeContext *s = ctx->priv;
+
+    for (int i = 2; i < s->nb_inputs; i++) { // slideshow inputs
+        AVFilterPad pad = xfade_inputs[1];
+        int ret;
+
+        pad.name = av_asprintf("input%d", i);
+        if (!pad.name)
+            return AVERROR(ENOMEM);
+        if ((ret = ff_append_inpad_free_name(ctx, &pad)) < 0)
+            return ret;
+    }
+    return 0;
+}
+
 static const AVFilterPad xfade_outputs[] = {
     {
         .name          = "default",
@@ -2415,11 +2659,13 @@ const FFFilter ff_vf_xfade = {
     .p.name        = "xfade",
     .p.description = NULL_IF_CONFIG_SMALL("Cross fade one video with another video."),
     .p.priv_class  = &xfade_class,
-    .p.flags       = AVFILTER_FLAG_SLICE_THREADS,
+    .p.flags       = AVFILTER_FLAG_SLICE_THREADS | AVFILTER_FLAG_DYNAMIC_INPUTS,
     .priv_size     = sizeof(XFadeContext),
+    .init          = init,
     .activate      = xfade_activate,
     .uninit        = uninit,
+    .process_command = xe_process_command,
     FILTER_INPUTS(xfade_inputs),
     FILTER_OUTPUTS(xfade_outputs),
-    FILTER_PIXFMTS_ARRAY(pix_fmts),
+    FILTER_QUERY_FUNC2(query_formats),
 };
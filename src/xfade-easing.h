@@ -10,11 +10,14 @@
 #include <stdbool.h>
 #include <float.h>
 #include <ctype.h>
+#include <stdatomic.h>
 #include "libavfilter/version.h"
 #include "libavutil/avstring.h"
+#include "libavutil/imgutils.h"
 #include "libavutil/mem.h"
 #include "libavutil/mem_internal.h"
 #include "libavutil/parseutils.h"
+#include "libavutil/time.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // definitions & prototypes
@@ -24,6 +27,7 @@
 #define M_SQRT3f 1.732050807568877f /* sqrt(3) */
 #define M_TAUf (M_PIf + M_PIf) /* 2*pi */
 #define M_1_TAUf (M_1_PIf * P5f) /* 1/(2*pi) */
+#define MAX_BATCH 64 /* maximum frames rendered concurrently (option batch) */
 
 //#define USEf(func, ...) USE_##func(__VA_ARGS__)
 #ifdef USEf /* debug: trap stdlib double calls */
@@ -64,6 +68,10 @@ static void xe_debug(void *avcl, const char *fmt, ...);
 // reverse bit flags
 typedef enum { REVERSE_TRANSITION = 1, REVERSE_EASING = 2, REVERSE_OVERSHOOT = 8 } ReverseFlags;
 
+// resampling of inputs of different size
+typedef enum { RESIZE_NONE, RESIZE_NEAREST, RESIZE_BILINEAR } ResizeMode;
+typedef enum { MASK_NONE, MASK_B, MASK_A } MaskMode; // option mask: input weighted by the custom expression
+
 // blend modes
 typedef enum {
     NORMAL, MULTIPLY, SCREEN, OVERLAY, DARKEN, LIGHTEN, COLORDODGE, COLORBURN,
@@ -131,12 +139,50 @@ typedef struct XFadeEasingContext {
     float framerate;
     float duration; // seconds
     float r; // frame aspect ratio
-    int n; // number of planes
+    int n; // number of components
+    struct Comp { // component layout in plane order (GBRA or YUVA)
+        int plane, step, offset; // plane, elements per pixel, element offset
+        int sx, sy; // log2 chroma subsampling
+    } comp[4];
+    bool subsampled; // xfade kernels run per plane at chroma resolution
+    AVFrame *uv[3]; // planar chroma for xfade transitions on semi-planar formats (from, to, out)
     int mw, mh; // maximum width, height
     int mv; // maximum pixel value
     bool is_rgb; // pixel format is RGB type
-    bool is_16; // pixel depth > 8
+    const struct YUVMatrix *yuv; // colour matrix if not RGB
+    bool is_16; // pixel depth > 8, integer
+    bool is_float; // pixel format is float, normalised
+    bool is_timed; // rendering depends on uneased time (animated texture)
     bool init; // true when initialised
+    int chunk; // adaptive rows per slice job
+    bool gather; // gathers from a wide 2-D footprint, rendered in tiles by default
+    void (*regionf)(AVFilterContext *ctx, const AVFrame *a, const AVFrame *b, AVFrame *out, float progress,
+                    int x0, int x1, int y0, int y1); // extended transition region renderer
+    struct XFadeCache { // last render, for reuse
+        AVFrame *xf[2], *out; // refs
+        float progress; // eased
+    } cache;
+    struct XFadeConvert { // last second input converted to the output format and size
+        AVFrame *in, *out; // refs
+    } converted;
+    struct XEProgram *program; // compiled custom expression
+    struct XFadeStep { // frame progress, precomputed per frame index
+        int64_t pts; // from transition start, output time base
+        float progress, eased; // easing argument and unclipped result (cf. PU, PE)
+        float p; // reversed and overshoot-resolved transition progress
+        int swap; // inputs swapped
+    } *steps; // alloc
+    int nb_steps;
+    AVRational frame_pts; // frame duration, output time base
+    struct XFadeBatch { // frame pairs held for concurrent rendering across activations (option batch)
+        AVFrame *xf[MAX_BATCH][2]; // consumed inputs, second converted
+        AVFrame *out[MAX_BATCH]; // rendered, awaiting output
+        ThreadData td[MAX_BATCH];
+        const ThreadData *r[MAX_BATCH]; // to render
+        int n; // pairs held
+        int next; // next output to emit, -1 until rendered
+        bool end; // transition ends at the last pair
+    } batch;
     const struct XFadeContext *s; // the XFadeContext
 } XFadeEasingContext;
 
@@ -148,6 +194,7 @@ typedef struct XTransition {
     vec2 p; // pixel position, .y==0 is bottom (cf. X, Y)
     vec4 a, b; // plane data at p (cf. A, B)
     const struct XFadeEasingContext *k; // the XFadeEasingContext
+    bool *timed; // set during initialisation if a colour arg is an animated texture
 } XTransition;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -341,6 +388,186 @@ static float css_steps(const XFadeEasingContext *k, float t)
     return (float)s / n;
 }
 
+// expression easings --------------------------------------------------
+
+// native easing functions for custom expressions, av_expr_parse() func1 and func2 tables, e.g. ease_elastic_out(x),
+// ease_cubic(x) (in-out), ease_css_in_out(x), ease_steps(x,n), with x clipped to the unit interval,
+// cf. expr/generic-easings-*.txt
+
+static const XFadeEasingContext xe_ease_mode[] = { // indexed by mode
+    [EASE_INOUT] = { .eargs = { .e.mode = EASE_INOUT } },
+    [EASE_IN] = { .eargs = { .e.mode = EASE_IN } },
+    [EASE_OUT] = { .eargs = { .e.mode = EASE_OUT } }
+};
+
+static const XFadeEasingContext xe_ease_bezier[] = { // CSS ease, ease-in, ease-out, ease-in-out
+    { .eargs = { .type = BEZIER, .b = {{ 0.25, 0.1, 0.25, 1. }} }, .duration = 10 }, // epsilon for 10s
+    { .eargs = { .type = BEZIER, .b = {{ 0.42, 0., 1., 1. }} }, .duration = 10 },
+    { .eargs = { .type = BEZIER, .b = {{ 0., 0., 0.58, 1. }} }, .duration = 10 },
+    { .eargs = { .type = BEZIER, .b = {{ 0.42, 0., 0.58, 1. }} }, .duration = 10 }
+};
+
+#define XE_EASINGS(X) \
+    X(quadratic, rp_quadratic) X(cubic, rp_cubic) X(quartic, rp_quartic) X(quintic, rp_quintic) \
+    X(sinusoidal, rp_sinusoidal) X(exponential, rp_exponential) X(circular, rp_circular) \
+    X(elastic, rp_elastic) X(back, rp_back) X(bounce, rp_bounce) X(squareroot, se_squareroot) \
+    X(cuberoot, se_cuberoot) X(flipelastic, se_flipelastic) X(flipback, se_flipback)
+
+#define XE_EASE(name, f, k) \
+static double xe_ease_##name(void *opaque, double x) { return f(k, av_clipd(x, 0, 1)); }
+#define XE_EASE_MODES(name, f) \
+    XE_EASE(name, f, &xe_ease_mode[EASE_INOUT]) XE_EASE(name##_in, f, &xe_ease_mode[EASE_IN]) \
+    XE_EASE(name##_out, f, &xe_ease_mode[EASE_OUT])
+#define XE_EASE_NAMES(name, f) "ease_" #name, "ease_" #name "_in", "ease_" #name "_out",
+#define XE_EASE_FUNCS(name, f) xe_ease_##name, xe_ease_##name##_in, xe_ease_##name##_out,
+
+XE_EASINGS(XE_EASE_MODES)
+XE_EASE(css, css_cubic_bezier, &xe_ease_bezier[0])
+XE_EASE(css_in, css_cubic_bezier, &xe_ease_bezier[1])
+XE_EASE(css_out, css_cubic_bezier, &xe_ease_bezier[2])
+XE_EASE(css_in_out, css_cubic_bezier, &xe_ease_bezier[3])
+
+static const char *const xe_ease_func1_names[] = {
+    XE_EASINGS(XE_EASE_NAMES)
+    "ease_css", "ease_css_in", "ease_css_out", "ease_css_in_out",
+    NULL
+};
+
+static double (*const xe_ease_func1[])(void *, double) = {
+    XE_EASINGS(XE_EASE_FUNCS)
+    xe_ease_css, xe_ease_css_in, xe_ease_css_out, xe_ease_css_in_out,
+    NULL
+};
+
+// CSS steps(n, jump-end)
+static double xe_ease_steps(void *opaque, double x, double n)
+{
+    n = floor(av_clipd(n, 1, INT_MAX));
+    return floor(av_clipd(x, 0, 1) * n) / n;
+}
+
+// batch easings --------------------------------------------------
+
+// branch-free element easings per mode, as the standard and supplementary easings above value for value:
+// in-out easings compute both halves and select bitwise, as compilers honouring FP traps will not select floats,
+// so loops over them vectorise (given -fno-math-errno, as FFmpeg builds, for sqrtf)
+
+static av_always_inline float ea_select(bool c, float a, float b) // c ? a : b
+{
+    union { float f; int32_t i; } x = { a }, y = { b };
+    x.i = (x.i & -(int32_t)c) | (y.i & ((int32_t)c - 1));
+    return x.f;
+}
+
+static av_always_inline float ea_quadratic(float t) { const float a = t * t * 2, b = (2 - t) * t * 2 - 1; return ea_select(t < P5f, a, b); }
+static av_always_inline float ea_quadratic_in(float t) { return t * t; }
+static av_always_inline float ea_quadratic_out(float t) { return (2 - t) * t; }
+
+static av_always_inline float ea_cubic(float t) { const float u = t - 1, a = t * t * t * 4, b = u * u * u * 4 + 1; return ea_select(t < P5f, a, b); }
+static av_always_inline float ea_cubic_in(float t) { return t * t * t; }
+static av_always_inline float ea_cubic_out(float t) { t -= 1; return t * t * t + 1; }
+
+static av_always_inline float ea_quartic(float t)
+{
+    const float s = t * t, u = (t - 1) * (t - 1), a = s * s * 8, b = u * u * -8 + 1;
+    return ea_select(t < P5f, a, b);
+}
+static av_always_inline float ea_quartic_in(float t) { t *= t; return t * t; }
+static av_always_inline float ea_quartic_out(float t) { t -= 1, t *= t; return 1 - t * t; }
+
+static av_always_inline float ea_quintic(float t)
+{
+    const float s = t * t, u = t - 1, v = u * u, a = s * s * t * 16, b = v * v * u * 16 + 1;
+    return ea_select(t < P5f, a, b);
+}
+static av_always_inline float ea_quintic_in(float t) { const float s = t * t; return s * s * t; }
+static av_always_inline float ea_quintic_out(float t) { const float u = t - 1, v = u * u; return v * v * u + 1; }
+
+static av_always_inline float ea_circular(float t)
+{
+    const float u = t - 1, a = (1 - sqrtf(1 - t * t * 4)) / 2, b = (1 + sqrtf(1 - u * u * 4)) / 2;
+    return ea_select(t < P5f, a, b);
+}
+static av_always_inline float ea_circular_in(float t) { return 1 - sqrtf(1 - t * t); }
+static av_always_inline float ea_circular_out(float t) { return sqrtf((2 - t) * t); }
+
+static av_always_inline float ea_back(float t)
+{
+    float r = 1 - t, b = 1.70158f; // for 10% back
+    b *= 1.525f;
+    const float u = t * t * (t * (b + 1) * 2 - b) * 2, v = 1 - r * r * (r * (b + 1) * 2 - b) * 2;
+    return ea_select(t < P5f, u, v);
+}
+static av_always_inline float ea_back_in(float t) { const float b = 1.70158f; return t * t * (t * (b + 1) - b); }
+static av_always_inline float ea_back_out(float t) { const float r = 1 - t, b = 1.70158f; return 1 - r * r * (r * (b + 1) - b); }
+
+static av_always_inline float ea_bounce_curve(float t) // bounce-out of t in the unit interval, piecewise by select
+{
+    const bool b1 = t < (4.f / 11.f), b2 = t < (8.f / 11.f), b3 = t < (10.f / 11.f);
+    const float c = ea_select(b1, 0, ea_select(b2, 3.f / 4.f, ea_select(b3, 15.f / 16.f, 63.f / 64.f)));
+    t -= ea_select(b1, 0, ea_select(b2, 6.f / 11.f, ea_select(b3, 9.f / 11.f, 21.f / 22.f)));
+    return t * t * (121.f / 16.f) + c;
+}
+static av_always_inline float ea_bounce(float t) { const float s = ea_select(t < P5f, 1, -1); return (1 - ea_bounce_curve((1 - t - t) * s) * s) / 2; }
+static av_always_inline float ea_bounce_in(float t) { return 1 - ea_bounce_curve(1 - t); }
+static av_always_inline float ea_bounce_out(float t) { return ea_bounce_curve(t); }
+
+static av_always_inline float ea_squareroot(float t) { const float r = sqrtf(ea_select(t < P5f, t + t, 2 - t - t)) / 2; return ea_select(t < P5f, r, 1 - r); }
+static av_always_inline float ea_squareroot_in(float t) { return sqrtf(t); }
+static av_always_inline float ea_squareroot_out(float t) { return 1 - sqrtf(1 - t); }
+
+static av_always_inline float ea_flip(float t) { return ea_select(t < 0, -t, ea_select(t > 1, 2 - t, t)); }
+static av_always_inline float ea_flipback(float t) { return ea_flip(ea_back(t)); }
+static av_always_inline float ea_flipback_in(float t) { return ea_flip(ea_back_in(t)); }
+static av_always_inline float ea_flipback_out(float t) { return ea_flip(ea_back_out(t)); }
+
+// libm easings gain nothing from both halves or from vectorising scalar calls, so resolve only the mode
+
+#define EA_MODES(name, f) \
+static av_always_inline float ea_##name(float t) { return f(&xe_ease_mode[EASE_INOUT], t); } \
+static av_always_inline float ea_##name##_in(float t) { return f(&xe_ease_mode[EASE_IN], t); } \
+static av_always_inline float ea_##name##_out(float t) { return f(&xe_ease_mode[EASE_OUT], t); }
+EA_MODES(sinusoidal, rp_sinusoidal) EA_MODES(exponential, rp_exponential) EA_MODES(elastic, rp_elastic)
+EA_MODES(cuberoot, se_cuberoot) EA_MODES(flipelastic, se_flipelastic)
+
+#define XE_EASE_ARRAY(name)                                                    \
+static void xe_ease_array_##name(float *dst, const float *src, int n)          \
+{                                                                              \
+    for (int i = 0; i < n; i++)                                                \
+        dst[i] = ea_##name(src[i]);                                            \
+}
+#define XE_EASE_ARRAY_MODES(name, f) XE_EASE_ARRAY(name) XE_EASE_ARRAY(name##_in) XE_EASE_ARRAY(name##_out)
+#define XE_EASE_ARRAY_KERNELS(name, f) { f, { xe_ease_array_##name, xe_ease_array_##name##_in, xe_ease_array_##name##_out } },
+
+XE_EASINGS(XE_EASE_ARRAY_MODES)
+
+static const struct XFadeEaseArray {
+    float (*easingf)(const XFadeEasingContext *k, float t);
+    void (*kernel[3])(float *dst, const float *src, int n); // indexed by mode
+} xe_ease_arrays[] = {
+    XE_EASINGS(XE_EASE_ARRAY_KERNELS)
+};
+
+// ease n values as k->easingf() does, dst may be src, for tables and per-item easing in any filter including this:
+// standard and supplementary easings resolve their mode once per call and run a branch-free kernel,
+// CSS easings run value by value
+static void xe_ease_array(const XFadeEasingContext *k, float *dst, const float *src, int n)
+{
+    if (!k->easingf) {
+        if (dst != src)
+            memcpy(dst, src, n * sizeof(*dst));
+        return;
+    }
+    for (int i = 0; i < FF_ARRAY_ELEMS(xe_ease_arrays); i++) {
+        if (xe_ease_arrays[i].easingf == k->easingf) {
+            xe_ease_arrays[i].kernel[k->eargs.e.mode](dst, src, n);
+            return;
+        }
+    }
+    for (int i = 0; i < n; i++)
+        dst[i] = k->easingf(k, src[i]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // extended transitions
 ////////////////////////////////////////////////////////////////////////////////
@@ -448,29 +675,46 @@ static inline vec4 normalize3(vec4 c) { return div3f(c, length3(c)); }
 
 // colour conversion --------------------------------------------------
 
-// convert GBR to YUV standard-definition BT.601
-// TODO: support high-definition BT.709 too?
+// YUV colour matrices (limited range) from luma coefficients Kr, Kb: BT.601, BT.709, BT.2020
 // see https://en.wikipedia.org/wiki/YCbCr#ITU-R_BT.601_conversion
+typedef struct YUVMatrix {
+    vec4 y, u, v; // GBR to YUV rows
+    float gu, gv, bu, rv; // YUV to GBR coefficients
+} YUVMatrix;
+#define YUV_MATRIX(kr, kb) {                                                          \
+    .y = {{ (1 - kr - kb) * 219./255, kb * 219./255, kr * 219./255 }},               \
+    .u = {{ -(1 - kr - kb) / (1 - kb) * 112./255, 112./255, -kr / (1 - kb) * 112./255 }}, \
+    .v = {{ -(1 - kr - kb) / (1 - kr) * 112./255, -kb / (1 - kr) * 112./255, 112./255 }}, \
+    .gu = -kb / (1 - kr - kb) * 255./224 * 2 * (1 - kb),                             \
+    .gv = -kr / (1 - kr - kb) * 255./224 * 2 * (1 - kr),                             \
+    .bu = 255./224 * 2 * (1 - kb), .rv = 255./224 * 2 * (1 - kr) }
+static const YUVMatrix BT601 = YUV_MATRIX(0.299, 0.114), BT709 = YUV_MATRIX(0.2126, 0.0722),
+                       BT2020 = YUV_MATRIX(0.2627, 0.0593);
 static const vec4 Od = {{ 16./255, 128./255, 128./255, 0 }}; // digital headroom/toeroom offsets
-static inline vec4 gbr2yuv(vec4 c)
+
+// YUV matrix of colorspace, BT.601 if unspecified
+static const YUVMatrix *yuv_matrix(enum AVColorSpace colorspace)
+{
+    switch (colorspace) {
+    case AVCOL_SPC_BT709: return &BT709;
+    case AVCOL_SPC_BT2020_NCL:
+    case AVCOL_SPC_BT2020_CL: return &BT2020;
+    default: return &BT601;
+    }
+}
+
+// convert GBR to YUV
+static inline vec4 gbr2yuv(vec4 c, const YUVMatrix *m)
 {
-    // BT.601 matrix                G            B            R
-    static const vec4 Y = {{ 128.553/255,  24.966/255,  65.481/255 }},
-                      U = {{ -74.203/255,    112./255, -37.797/255 }},
-                      V = {{ -93.786/255, -18.214/255,    112./255 }};
-    return add4(VEC4(dot3(c, Y), dot3(c, U), dot3(c, V), c.p3), Od);
+    return add4(VEC4(dot3(c, m->y), dot3(c, m->u), dot3(c, m->v), c.p3), Od);
 }
 
 // convert YUV to GBR
-static inline vec4 yuv2gbr(vec4 c)
+static inline vec4 yuv2gbr(vec4 c, const YUVMatrix *m)
 {
-    // inverse BT.601 matrix
-    #define BU 255./224*1.772
-    #define RV 255./224*1.402
-    static const float Bu = BU, Rv = RV, Gy = 255./219, Gu = -0.114/0.587*BU, Gv = -0.299/0.587*RV;
     c = sub4(c, Od);
-    float y = c.p0 * Gy; // Y G=B=R
-    return VEC4(y + c.p1 * Gu + c.p2 * Gv, y + c.p1 * Bu, y + c.p2 * Rv, c.p3);
+    float y = c.p0 * (255.f / 219); // Y G=B=R
+    return VEC4(y + c.p1 * m->gu + c.p2 * m->gv, y + c.p1 * m->bu, y + c.p2 * m->rv, c.p3);
 }
 
 // blending --------------------------------------------------
@@ -553,7 +797,7 @@ static vec4 composite(vec4 b, vec4 f, vec4 c) { // bg, fg, blended
 static vec4 blend(const XTransition *e, vec4 b, vec4 f, BlendMode mode) { // bg, fg, mode
     vec4 c;
     if (!e->k->is_rgb)
-        b = yuv2gbr(b), f = yuv2gbr(f);
+        b = yuv2gbr(b, e->k->yuv), f = yuv2gbr(f, e->k->yuv);
     #define BLEND3(n) VEC3(n(b.p0, f.p0), n(b.p1, f.p1), n(b.p2, f.p2))
     switch (mode) {
         default:         c = BLEND3(normal); break; // NORMAL
@@ -576,15 +820,15 @@ static vec4 blend(const XTransition *e, vec4 b, vec4 f, BlendMode mode) { // bg,
     c = composite(b, f, c);
     c = clipUI4(c);
     if (!e->k->is_rgb)
-        c = gbr2yuv(c);
+        c = gbr2yuv(c, e->k->yuv);
     return c;
 }
 
 // get/set pixel data --------------------------------------------------
 
-// nb_planes is always 1, 3 or 4
-// nb_planes = 1: (gray/mono) processed as YUV so set u,v to 0.5
-// nb_planes < 4: (opaque) set alpha to 1
+// nb_components is always 1, 3 or 4
+// nb_components = 1: (gray/mono) processed as YUV so set u,v to 0.5
+// nb_components < 4: (opaque) set alpha to 1
 #define PLANED ((vec4) { .p1 = P5f, .p2 = P5f, .p3 = 1 }) // default plane data
 
 // scale unit interval to clipped integer
@@ -593,7 +837,36 @@ static inline int scaleUI(float val, int max) { return av_clip(val * max + P5f,
 
 // get pointer to line of plane data at y
 static av_always_inline uint8_t *pix8(const AVFrame *f, int p, int x, int y) { return &f->data[p][f->linesize[p] * y + x]; }
-static av_always_inline uint16_t *pix16(const AVFrame *f, int p, int x, int y) { return &((uint16_t*)pix8(f, p, y, 0))[x]; }
+static av_always_inline uint16_t *pix16(const AVFrame *f, int p, int x, int y) { return &((uint16_t*)pix8(f, p, 0, y))[x]; }
+
+static av_always_inline float *pix32(const AVFrame *f, int p, int x, int y) { return &((float*)pix8(f, p, 0, y))[x]; }
+
+// get pointer to component data at pixel x,y, planar, packed or subsampled
+static av_always_inline uint8_t *comp8(const XFadeEasingContext *k, const AVFrame *f, int p, int x, int y)
+{
+    const struct Comp *c = &k->comp[p];
+    return pix8(f, c->plane, (x >> c->sx) * c->step + c->offset, y >> c->sy);
+}
+static av_always_inline uint16_t *comp16(const XFadeEasingContext *k, const AVFrame *f, int p, int x, int y)
+{
+    const struct Comp *c = &k->comp[p];
+    return pix16(f, c->plane, (x >> c->sx) * c->step + c->offset, y >> c->sy);
+}
+static av_always_inline float *comp32(const XFadeEasingContext *k, const AVFrame *f, int p, int x, int y)
+{
+    const struct Comp *c = &k->comp[p];
+    return pix32(f, c->plane, (x >> c->sx) * c->step + c->offset, y >> c->sy);
+}
+
+// normalise component value, float is already normalised
+static av_always_inline float load8(const uint8_t *v, float sv) { return *v * sv; }
+static av_always_inline float load16(const uint16_t *v, float sv) { return *v * sv; }
+static av_always_inline float load32(const float *v, float sv) { return *v; }
+
+// store normalised component value, float is unquantised
+static av_always_inline void store8(uint8_t *v, float c, int mv) { *v = scaleUI(c, mv); }
+static av_always_inline void store16(uint16_t *v, float c, int mv) { *v = scaleUI(c, mv); }
+static av_always_inline void store32(float *v, float c, int mv) { *v = c; }
 
 #define _getFromColor1(v) getColor(e, v.x, v.y, 0)
 #define _getFromColor2(x, y) getColor(e, (x), (y), 0)
@@ -613,13 +886,17 @@ static av_noinline vec4 getColor(const XTransition *e, float x, float y, int nb)
     const float sv = 1.f / k->mv; // UI scale value
     vec4 c = PLANED; // default plane values
     int p = 0;
-    if (k->is_16)
+    if (k->is_float)
+        do
+            c.p[p] = *comp32(k, f, p, i, j);
+        while (++p < n);
+    else if (k->is_16)
         do
-            c.p[p] = *pix16(f, p, i, j) * sv;
+            c.p[p] = *comp16(k, f, p, i, j) * sv;
         while (++p < n);
     else
         do
-            c.p[p] = *pix8(f, p, i, j) * sv;
+            c.p[p] = *comp8(k, f, p, i, j) * sv;
         while (++p < n);
     return c;
 }
@@ -641,12 +918,12 @@ static vec4 colour(const XTransition *e, Colour value)
         uint8_t r = rgba >> 24, g = rgba >> 16, b = rgba >> 8, a = rgba;
         c = mul4f(VEC4(g, b, r, a), 1.f / 255); // normalised GBRA
         if (!k->is_rgb)
-            c = gbr2yuv(c); // normalised YUVA
+            c = gbr2yuv(c, k->yuv); // normalised YUVA
     } else if (value <= -2) { // texture
         int type = value; // texture type (trunc)
         c = texture(e, type); // create texture
         if (!k->is_rgb)
-            c = gbr2yuv(c);
+            c = gbr2yuv(c, k->yuv);
     } else { // greyscale
         bool s = signbit(value); // for neg zero
         float grey = s ? clipUI(-value) : value;
@@ -661,6 +938,8 @@ static void arg4(const XTransition *e, double value)
 {
     const XFadeEasingContext *k = e->k;
     vec4 c = colour(e, value);
+    if (value <= -2 && !((int)value & 1) && e->timed) // animated texture
+        *e->timed = true;
     const char *t = (value < -1) ? "texture"
                   : signbit(value) ? "transparent"
                   : (value <= 1) ? "grey"
@@ -670,7 +949,7 @@ static void arg4(const XTransition *e, double value)
     } else if (value <= 1 || k->is_rgb) { // transparent/greyscale/RGBA
         xe_debug(NULL, "colour: %s = %g %g %g %g\n", t, c.p0, c.p1, c.p2, c.p3);
     } else { // YUVA
-        vec4 d = yuv2gbr(c); // test conversions
+        vec4 d = yuv2gbr(c, k->yuv); // test conversions
         int v[4]; for (int i = 0; i < 4; i++) v[i] = scaleUI(d.p[i], 255);
         xe_debug(NULL, "colour: %s = %g %g %g %g (#%02X%02X%02X%02X)\n",
                  t, c.p0, c.p1, c.p2, c.p3, v[2], v[0], v[1], v[3]);
@@ -1158,7 +1437,7 @@ static vec4 gl_EdgeTransition(const XTransition *e) // by Woohyun Kim
     if (e->k->is_rgb)
         f = e->a, t = e->b;
     else
-        f = yuv2gbr(e->a), t = yuv2gbr(e->b); // TODO: what if not BT.601?
+        f = yuv2gbr(e->a, e->k->yuv), t = yuv2gbr(e->b, e->k->yuv);
     vec4 a[2] = { f, t }; // adjacent mix colours
     for (int k = 0; k < 2; k++) {
         vec4 c[9]; // adjacent pixel array for e->p: 0 3 6
@@ -1167,7 +1446,7 @@ static vec4 gl_EdgeTransition(const XTransition *e) // by Woohyun Kim
                 ivec2 j = { i / 3 - 1, i % 3 - 1 };
                 vec2 p = add2(e->p, mul2f(vec2i(j), edgeThickness));
                 o = k ? getToColor(p) : getFromColor(p);
-                c[i] = e->k->is_rgb ? o : yuv2gbr(o);
+                c[i] = e->k->is_rgb ? o : yuv2gbr(o, e->k->yuv);
             }
         }
         vec4 dx = add3(mul3f(abs3(sub3(c[7], c[1])), 2), add3(abs3(sub3(c[2], c[6])), abs3(sub3(c[8], c[0]))));
@@ -1181,7 +1460,7 @@ static vec4 gl_EdgeTransition(const XTransition *e) // by Woohyun Kim
     else
         start = a[0], end = mix4(a[1], t, e->progress * 2 - 1);
     o = mix4(start, end, e->progress);
-    return e->k->is_rgb ? o : gbr2yuv(o);
+    return e->k->is_rgb ? o : gbr2yuv(o, e->k->yuv);
 }
 
 static vec4 gl_Exponential_Swish(const XTransition *e) // by Boundless
@@ -2373,30 +2652,88 @@ static vec4 texture(const XTransition *e, int type)
 // easing delegate
 ////////////////////////////////////////////////////////////////////////////////
 
-static float ease(XFadeContext *s, float progress)
+static float ease(const XFadeEasingContext *k, float progress)
 {
-    const XFadeEasingContext *k = s->k;
-    if (!k->easingf)
-        return progress; // uneased
-    float eased = 1 - k->easingf(k, 1 - progress); // (1 to 0 for xfade)
-    if (s->transition == CUSTOM) {
-        // make uneased progress P available as ld(0) and eased progress available as ld(1)
-        // primarily for testing easing functions and generating easing plots
-        // horrible hack here due to incomplete definition of type 'struct AVExpr' at s->e
-        // TODO: find a neat thread-safe way to implement this hook for slices
-        typedef struct { // this must mimic struct AVExpr member sizeofs, see libavutil/eval.c
-            int type;
-            double value;
-            int const_index;
-            double (*func0)(double);
-            struct AVExpr *param[3];
-            double *var;
-        } _AVExpr;
-        _AVExpr *e = (_AVExpr*)s->e;
-        e->var[0] = progress; // original P
-        e->var[1] = eased; // may lie outside UI
-    };
-    return eased;
+    return k->easingf ? 1 - k->easingf(k, 1 - progress) : progress; // (1 to 0 for xfade)
+}
+
+// easing argument (PU) at pts from transition start
+static float xe_step_progress(const XFadeContext *s, int64_t pts)
+{
+    const float progress = av_clipf(1.f - ((float)pts / s->duration_pts), 0.f, 1.f);
+    return (s->reverse & REVERSE_EASING) ? 1 - progress : progress;
+}
+
+// frame progress at pts from transition start, given its easing argument and result
+static struct XFadeStep xe_resolve_step(const XFadeContext *s, int64_t pts, float progress, float eased)
+{
+    struct XFadeStep t = { .pts = pts, .progress = progress, .eased = eased }; // eased may lie outside UI
+    progress = (s->reverse & REVERSE_EASING) ? 1 - t.eased : t.eased;
+    int i = s->reverse & REVERSE_TRANSITION;
+    if (i) progress = 1 - progress;
+    if (s->reverse & REVERSE_OVERSHOOT) { // internal flag
+        if (progress < 0) progress += 1, i ^= 1; // undershoot
+        else if (progress > 1) progress -= 1, i ^= 1; // overshoot
+    }
+    t.p = av_clipf(progress, 0, 1), t.swap = i;
+    return t;
+}
+
+// frame progress at pts from transition start
+static struct XFadeStep xe_step(const XFadeContext *s, int64_t pts)
+{
+    const float progress = xe_step_progress(s, pts);
+    return xe_resolve_step(s, pts, progress, ease(s->k, progress));
+}
+
+// frame index at pts from transition start, -1 if not at one in the table
+static int64_t xe_step_index(const XFadeEasingContext *k, int64_t pts)
+{
+    const int64_t i = k->steps && pts >= 0 ? av_rescale_rnd(pts, k->frame_pts.den, k->frame_pts.num, AV_ROUND_NEAR_INF) : -1;
+    return i >= 0 && i < k->nb_steps && k->steps[i].pts == pts ? i : -1;
+}
+
+// frame progress at pts from transition start, from the table if at a frame index
+static struct XFadeStep xe_lookup_step(const XFadeContext *s, int64_t pts)
+{
+    const int64_t i = xe_step_index(s->k, pts);
+    return i >= 0 ? s->k->steps[i] : xe_step(s, pts);
+}
+
+// set thread data inputs and eased progress for frame at s->pts
+static void xe_thread_data(XFadeContext *s, const AVFrame *a, const AVFrame *b, ThreadData *td)
+{
+    const struct XFadeStep t = xe_lookup_step(s, s->pts - s->start_pts);
+    s->progress[0] = t.progress, s->progress[1] = t.eased; // custom expression variables PU and PE
+    td->xf[t.swap] = a, td->xf[t.swap ^ 1] = b, td->progress = t.p;
+    td->uneased = t.progress, td->eased = t.eased;
+}
+
+// export progress as frame metadata lavfi.xfade.progress, lavfi.xfade.eased (PU, PE) and lavfi.xfade.active
+static void set_progress_metadata(AVFrame *f, float uneased, float eased, int active)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%f", uneased);
+    av_dict_set(&f->metadata, "lavfi.xfade.progress", buf, 0);
+    snprintf(buf, sizeof(buf), "%f", eased);
+    av_dict_set(&f->metadata, "lavfi.xfade.eased", buf, 0);
+    av_dict_set(&f->metadata, "lavfi.xfade.active", active ? "1" : "0", 0);
+}
+
+// metadata for a transition frame, with the progress values it was rendered with
+static void xe_frame_metadata(AVFrame *out, const ThreadData *td)
+{
+    set_progress_metadata(out, td->uneased, td->eased, 1);
+}
+
+// metadata for a frame passed through before or after the transition, with its first or last progress,
+// unless tagged already by an upstream xfade, so chained transitions keep their own frames' values
+static void xe_passthrough_metadata(const XFadeContext *s, AVFrame *f, int after)
+{
+    if (av_dict_get(f->metadata, "lavfi.xfade.active", NULL, 0))
+        return;
+    const struct XFadeStep t = xe_lookup_step(s, after ? s->duration_pts : 0);
+    set_progress_metadata(f, t.progress, t.eased, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2404,12 +2741,11 @@ static float ease(XFadeContext *s, float progress)
 ////////////////////////////////////////////////////////////////////////////////
 
 #define XTRANSITION_TRANSITION(type, bits)                                     \
-static av_noinline void xtransition##bits##_transition(AVFilterContext *ctx,   \
+static av_noinline void xtransition##bits##_region(AVFilterContext *ctx,       \
                                            const AVFrame *a, const AVFrame *b, \
                                            AVFrame *out,                       \
                                            float progress,                     \
-                                           int slice_start, int slice_end,     \
-                                           int jobnr)                          \
+                                           int x0, int x1, int y0, int y1)     \
 {                                                                              \
     const XFadeContext *s = ctx->priv;                                         \
     const XFadeEasingContext *k = s->k;                                        \
@@ -2421,212 +2757,2177 @@ static av_noinline void xtransition##bits##_transition(AVFilterContext *ctx,   \
         .k = k /* common context */                                            \
     };                                                                         \
     /* pixel iterator and unit interval conversions */                         \
-    for (int y = slice_start; y < slice_end; y++) {                            \
+    for (int y = y0; y < y1; y++) {                                            \
         e.p.y = 1 - y * sh; /* y=0 is bottom */                                \
-        for (int x = 0, p = 0; x <= k->mw; x++) {                              \
+        for (int x = x0, p = 0; x < x1; x++) {                                 \
             e.p.x = x * sw;                                                    \
             e.a = PLANED, e.b = PLANED; /* plane defaults */                   \
             do {                                                               \
-                e.a.p[p] = *pix##bits(a, p, x, y) * sv; /* from colour */      \
-                e.b.p[p] = *pix##bits(b, p, x, y) * sv; /* to colour */        \
+                e.a.p[p] = load##bits(comp##bits(k, a, p, x, y), sv);          \
+                e.b.p[p] = load##bits(comp##bits(k, b, p, x, y), sv);          \
             } while (++p < k->n);                                              \
             vec4 c = k->xtransitionf(&e); /* transition colour */              \
             do {                                                               \
-                --p;                                                           \
-                *pix##bits(out, p, x, y) = scaleUI(c.p[p], k->mv); /* clips */ \
+                const struct Comp *d = &k->comp[--p];                          \
+                if (x >> d->sx << d->sx == x && /* plane sample site */        \
+                    y >> d->sy << d->sy == y)                                  \
+                    store##bits(comp##bits(k, out, p, x, y), c.p[p], k->mv);   \
             } while (p > 0);                                                   \
         }                                                                      \
     }                                                                          \
+}                                                                              \
+                                                                               \
+static void xtransition##bits##_transition(AVFilterContext *ctx,               \
+                                           const AVFrame *a, const AVFrame *b, \
+                                           AVFrame *out,                       \
+                                           float progress,                     \
+                                           int slice_start, int slice_end,     \
+                                           int jobnr)                          \
+{                                                                              \
+    xtransition##bits##_region(ctx, a, b, out, progress,                       \
+                               0, out->width, slice_start, slice_end);         \
 }
 
 XTRANSITION_TRANSITION(uint8_t, 8)
 XTRANSITION_TRANSITION(uint16_t, 16)
+XTRANSITION_TRANSITION(float, 32)
 
 ////////////////////////////////////////////////////////////////////////////////
-// argument parsing
+// chroma subsampling
 ////////////////////////////////////////////////////////////////////////////////
 
-// emit error message, reduces verbosity
-static int xe_error(void *avcl, const char *fmt, ...)
+// 4:2:0 and 4:2:2 formats are processed natively, avoiding conversions either side of xfade:
+// the extended transition iterator evaluates every luma pixel, storing chroma at plane sample sites,
+// and xfade transitions run once per plane on a single-plane view at plane resolution
+// packed RGB formats are read and written in place by the extended transition iterator only,
+// through the component layout (plane, step, offset) taken from the pixel format descriptor
+// semi-planar NV12/P010 are read in place by the iterator, while xfade transitions work on chroma
+// split into planar scratch frames at chroma resolution, merging the rendered rows back
+// MSB-aligned formats (P010) are processed as 16 bit, their low bits being padding
+
+// start of the next |-separated slideshow item in option string t, else NULL
+static const char *next_item(const char *t)
 {
-    va_list args;
-    va_start(args, fmt);
-    av_vlog(avcl, AV_LOG_ERROR, fmt, args);
-    va_end(args);
-    return AVERROR(EINVAL);
+    return (t = strchr(t, '|')) ? t + 1 : NULL;
 }
 
-// emit warning message
-static void xe_warning(void *avcl, const char *fmt, ...)
+// true if transition option, or any slideshow item of it, names transition, ignoring spaces, before parsing
+static bool is_transition(const XFadeContext *s, const char *name)
 {
-    va_list args;
-    va_start(args, fmt);
-    av_vlog(avcl, AV_LOG_WARNING, fmt, args);
-    va_end(args);
+    const int n = strlen(name);
+    for (const char *t = s->transition_str; t; t = next_item(t)) {
+        t += strspn(t, " ");
+        const char c = t[n + strspn(t + n, " ")];
+        if (!av_strncasecmp(t, name, n) && (!c || c == '|'))
+            return true;
+    }
+    return false;
 }
 
-// emit debug message
-static void xe_debug(void *avcl, const char *fmt, ...)
+// transitions needing 4:4:4 (custom expressions address all planes by X,Y, fadegrays mixes planes per pixel)
+static bool xe_full_chroma(const XFadeContext *s)
 {
-    va_list args;
-    va_start(args, fmt);
-    av_log(avcl, AV_LOG_DEBUG, "xfade-easing: ");
-    av_vlog(avcl, AV_LOG_DEBUG, fmt, args);
-    va_end(args);
+    return is_transition(s, "custom") || is_transition(s, "fadegrays");
 }
 
-// remove extraneous spaces in place
-static void rmspace(char *s)
+// true for xfade transitions, which only process planar formats, false for extended transitions
+static bool xe_xfade_transition(const XFadeContext *s)
 {
-    char *d = s;
-    char c, l = 0;
-    while ((c = *s++)) {
-        // trim name part
-        if (c != '(') {
-            if (c != ' ')
-                l = c;
-            *d++ = c;
-            continue;
-        }
-        if (l)
-            while (d[-1] != l)
-                d--;
-        *d++ = l = c;
-        // trim args allowing single space between CSV tokens
-        bool b = 0, e;
-        while ((c = *s++)) {
-            if (c != ' ' || (b && l != ' ')) {
-                if ((e = (c == ',' || c == ')')))
-                    if (b && l == ' ')
-                        d--;
-                b = !e;
-                *d++ = l = c;
-            }
-        }
-        break;
-    }
-    *d = 0;
+    if (!s->transition_str || is_transition(s, ""))
+        return true; // default
+    for (const AVOption *o = xfade_options; o->name; o++)
+        if (!o->offset && o->unit && !strcmp(o->unit, "transition") && is_transition(s, o->name))
+            return true;
+    return false;
 }
 
-// like strtok_r but doesn't skip empty values between commas
-static char *csvtok(char *s, char **p)
+// single plane view of frame at plane resolution
+static void plane_view(AVFrame *v, const AVFrame *f, int p, int sx, int sy)
 {
-    char *c = s ? s : (s = *p);
-    if (!*c)
-        return NULL;
-    while (*c) {
-        if (*c++ == ',') {
-            c[-1] = 0;
-            break;
-        }
-    }
-    *p = c;
-    return s;
+    *v = *f; // shallow, no refs
+    v->data[0] = f->data[p];
+    v->linesize[0] = f->linesize[p];
+    v->width = AV_CEIL_RSHIFT(f->width, sx);
+    v->height = AV_CEIL_RSHIFT(f->height, sy);
 }
 
-// parse a number or colour
-static double argv(char *s, char **p)
+// run xfade kernel over all planes, or per component plane at its resolution when subsampled
+static void xe_kernel_transition(AVFilterContext *ctx, XFadeKernel kernel, const AVFrame *a, const AVFrame *b,
+                                 AVFrame *out, float progress, int slice_start, int slice_end, int jobnr)
 {
-    char *c;
-    double d = strtod(s, &c); // try number (inc. grey)
-    if (*s == '#' || !strncmp(s, "0x", 2) || isalpha(*s) || strchr(s, '@')) { // try colour
-        c = s;
-        uint8_t rgba[4];
-        if (!av_parse_color(rgba, s, -1, NULL)) { // (fails for 0X prefix)
-            uint32_t u = rgba[0] << 24 | rgba[1] << 16 | rgba[2] << 8 | rgba[3];
-            uint64_t l = u | 1ULL << 32; // colour flag bit 32 ensures value > 1
-            d = l;
-            c += strlen(s);
-        }
+    const XFadeContext *s = ctx->priv;
+    const XFadeEasingContext *k = s->k;
+    XFadePlanes l = { .nb_planes = s->nb_planes, .max_value = s->max_value, .is_rgb = s->is_rgb };
+    if (!k || !k->subsampled) {
+        memcpy(l.black, s->black, sizeof(l.black));
+        memcpy(l.white, s->white, sizeof(l.white));
+        kernel(&l, a, b, out, progress, slice_start, slice_end, jobnr);
+        return;
+    }
+    AVFrame va, vb, vo;
+    l.nb_planes = 1;
+    for (int p = 0; p < k->n; p++) {
+        const struct Comp *d = &k->comp[p];
+        const bool split = k->uv[0] && (p == 1 || p == 2); // semi-planar chroma
+        plane_view(&va, split ? k->uv[0] : a, split ? p : d->plane, d->sx, d->sy);
+        plane_view(&vb, split ? k->uv[1] : b, split ? p : d->plane, d->sx, d->sy);
+        plane_view(&vo, split ? k->uv[2] : out, split ? p : d->plane, d->sx, d->sy);
+        l.black[0] = s->black[p], l.white[0] = s->white[p];
+        kernel(&l, &va, &vb, &vo, progress,
+               AV_CEIL_RSHIFT(slice_start, d->sy), AV_CEIL_RSHIFT(slice_end, d->sy), jobnr);
     }
-    *p = c;
-    return d;
 }
 
-// standard/supplementary easing mode
-static int parse_standard_easing(AVFilterContext *ctx, char *args)
+// split (merge false) or merge interleaved chroma rows y0 to y1 of frame f with planar frame g
+#define SWAP_CHROMA(type, bits)                                                                    \
+static void swap_chroma##bits(const XFadeEasingContext *k, AVFrame *f, AVFrame *g,                 \
+                              int y0, int y1, bool merge)                                          \
+{                                                                                                  \
+    const struct Comp *u = &k->comp[1], *v = &k->comp[2];                                          \
+    const int width = AV_CEIL_RSHIFT(f->width, u->sx);                                             \
+    for (int y = y0; y < y1; y++) {                                                                \
+        type *c = (type *)(f->data[u->plane] + y * f->linesize[u->plane]);                         \
+        type *gu = (type *)(g->data[1] + y * g->linesize[1]);                                      \
+        type *gv = (type *)(g->data[2] + y * g->linesize[2]);                                      \
+        if (merge)                                                                                 \
+            for (int x = 0; x < width; x++)                                                        \
+                c[x * u->step + u->offset] = gu[x], c[x * v->step + v->offset] = gv[x];            \
+        else                                                                                       \
+            for (int x = 0; x < width; x++)                                                        \
+                gu[x] = c[x * u->step + u->offset], gv[x] = c[x * v->step + v->offset];            \
+    }                                                                                              \
+}
+
+SWAP_CHROMA(uint8_t, 8)
+SWAP_CHROMA(uint16_t, 16)
+
+// semi-planar chroma rows to swap
+typedef struct {
+    AVFrame *f, *g;
+    int start, rows;
+    bool merge;
+} ChromaData;
+
+// swap slice of chroma rows
+static int chroma_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
-    XFadeContext *s = ctx->priv;
-    struct Standard *a = &s->k->eargs.e;
-    s->k->eargs.type = STANDARD;
-    char *p = strchr(s->easing_str, '-');
-    if (!p) a->mode = EASE_INOUT;
-    else if (!av_strcasecmp(p, "-in-out")) a->mode = EASE_INOUT;
-    else if (!av_strcasecmp(p, "-in")) a->mode = EASE_IN;
-    else if (!av_strcasecmp(p, "-out")) a->mode = EASE_OUT;
-    else return xe_error(ctx, "unknown easing function %s\n", s->easing_str);
-    if (args)
-        xe_warning(ctx, "ignoring extraneous easing arguments %s\n", args);
-    xe_debug(ctx, "easing = %s[%d]\n", s->easing_str, a->mode);
+    const XFadeContext *s = ctx->priv;
+    const XFadeEasingContext *k = s->k;
+    const ChromaData *d = arg;
+    const int y0 = d->start + (d->rows *  jobnr     ) / nb_jobs;
+    const int y1 = d->start + (d->rows * (jobnr + 1)) / nb_jobs;
+    (k->is_16 ? swap_chroma16 : swap_chroma8)(k, d->f, d->g, y0, y1, d->merge);
     return 0;
 }
 
-// CSS linear()
-static int parse_linear_easing(AVFilterContext *ctx, char *args)
+// swap chroma of luma rows start to end between semi-planar frame and planar scratch frame
+static void xe_swap_chroma(AVFilterContext *ctx, const AVFrame *f, AVFrame *g, int start, int end, bool merge)
+{
+    const XFadeContext *s = ctx->priv;
+    const int sy = s->k->comp[1].sy;
+    ChromaData d = { (AVFrame *)f, g, AV_CEIL_RSHIFT(start, sy), AV_CEIL_RSHIFT(end, sy) - AV_CEIL_RSHIFT(start, sy), merge };
+    if (d.rows > 0)
+        ff_filter_execute(ctx, chroma_slice, &d, NULL, FFMIN(d.rows, ff_filter_get_nb_threads(ctx)));
+}
+
+// set up per plane rendering of xfade transitions
+// float built-in kernels, instantiated as name32 alongside name8 and name16
+#define FLOAT_KERNEL(T, name) case T: s->transitionf = name##32_transition; break;
+
+static int config_xfade_planes(AVFilterContext *ctx)
 {
-    if (!args)
-        return 0;
     XFadeContext *s = ctx->priv;
-    struct Linear *a = &s->k->eargs.l;
-    s->k->eargs.type = LINEAR;
-    // parse
-    char *e, *c, *b, *t;
-    float d = -FLT_MAX; // ensure x increases
-    while ((e = csvtok(args, &c))) { // each arg
-        if (!*e)
-            return xe_error(ctx, "expected number in easing option\n");
-        e = av_strtok(e, " ", &b);
-        float x = NAN, y = strtof(e, &t);
-        if (t == e || *t != 0)
-            return xe_error(ctx, "bad number %s in easing option\n", e);
-        int i, n = 1;
-        vec2 q[2];
-        for (i = 0; i < 2; i++) {
-            if ((e = av_strtok(NULL, " ", &b))) { // have %
-                x = strtof(e, &t);
-                if (t == e || *t != '%')
-                    return xe_error(ctx, "bad number %s in easing option\n", e);
-                x = d = maxf(x * 0.01f, d);
-                if (i)
-                    n++;
-            }
-            q[i] = VEC2(x, y);
+    XFadeEasingContext *k = s->k;
+    if (k->is_float) {
+        switch (s->transition) { // built-ins except custom & fadegrays, excluded by query_formats()
+        FLOAT_KERNEL(FADE, fade) FLOAT_KERNEL(WIPELEFT, wipeleft) FLOAT_KERNEL(WIPERIGHT, wiperight)
+        FLOAT_KERNEL(WIPEUP, wipeup) FLOAT_KERNEL(WIPEDOWN, wipedown) FLOAT_KERNEL(SLIDELEFT, slideleft)
+        FLOAT_KERNEL(SLIDERIGHT, slideright) FLOAT_KERNEL(SLIDEUP, slideup) FLOAT_KERNEL(SLIDEDOWN, slidedown)
+        FLOAT_KERNEL(CIRCLECROP, circlecrop) FLOAT_KERNEL(RECTCROP, rectcrop) FLOAT_KERNEL(DISTANCE, distance)
+        FLOAT_KERNEL(FADEBLACK, fadeblack) FLOAT_KERNEL(FADEWHITE, fadewhite) FLOAT_KERNEL(RADIAL, radial)
+        FLOAT_KERNEL(SMOOTHLEFT, smoothleft) FLOAT_KERNEL(SMOOTHRIGHT, smoothright) FLOAT_KERNEL(SMOOTHUP, smoothup)
+        FLOAT_KERNEL(SMOOTHDOWN, smoothdown) FLOAT_KERNEL(CIRCLEOPEN, circleopen) FLOAT_KERNEL(CIRCLECLOSE, circleclose)
+        FLOAT_KERNEL(VERTOPEN, vertopen) FLOAT_KERNEL(VERTCLOSE, vertclose) FLOAT_KERNEL(HORZOPEN, horzopen)
+        FLOAT_KERNEL(HORZCLOSE, horzclose) FLOAT_KERNEL(DISSOLVE, dissolve) FLOAT_KERNEL(PIXELIZE, pixelize)
+        FLOAT_KERNEL(DIAGTL, diagtl) FLOAT_KERNEL(DIAGTR, diagtr) FLOAT_KERNEL(DIAGBL, diagbl)
+        FLOAT_KERNEL(DIAGBR, diagbr) FLOAT_KERNEL(HLSLICE, hlslice) FLOAT_KERNEL(HRSLICE, hrslice)
+        FLOAT_KERNEL(VUSLICE, vuslice) FLOAT_KERNEL(VDSLICE, vdslice) FLOAT_KERNEL(HBLUR, hblur)
+        FLOAT_KERNEL(WIPETL, wipetl) FLOAT_KERNEL(WIPETR, wipetr) FLOAT_KERNEL(WIPEBL, wipebl)
+        FLOAT_KERNEL(WIPEBR, wipebr) FLOAT_KERNEL(SQUEEZEH, squeezeh) FLOAT_KERNEL(SQUEEZEV, squeezev)
+        FLOAT_KERNEL(ZOOMIN, zoomin) FLOAT_KERNEL(FADEFAST, fadefast) FLOAT_KERNEL(FADESLOW, fadeslow)
+        FLOAT_KERNEL(HLWIND, hlwind) FLOAT_KERNEL(HRWIND, hrwind) FLOAT_KERNEL(VUWIND, vuwind)
+        FLOAT_KERNEL(VDWIND, vdwind) FLOAT_KERNEL(COVERLEFT, coverleft) FLOAT_KERNEL(COVERRIGHT, coverright)
+        FLOAT_KERNEL(COVERUP, coverup) FLOAT_KERNEL(COVERDOWN, coverdown) FLOAT_KERNEL(REVEALLEFT, revealleft)
+        FLOAT_KERNEL(REVEALRIGHT, revealright) FLOAT_KERNEL(REVEALUP, revealup) FLOAT_KERNEL(REVEALDOWN, revealdown)
+        default: return AVERROR_BUG;
         }
-        if (!(a->points = av_realloc_array(a->points, a->stops + n, sizeof(*a->points))))
-            return AVERROR(ENOMEM);
-        for (i = 0; i < n; i++)
-            a->points[a->stops++] = q[i];
-        args = NULL;
     }
-    // interpolate x gaps
-    int n = a->stops;
-    if (n < 2)
-        return xe_error(ctx, "expected at least 2 easing arguments, got %d\n", n);
-    vec2 *p = a->points;
-    if (isnan(p[0].x))
-        p[0].x = 0;
-    if (isnan(p[n - 1].x))
-        p[n - 1].x = 1;
-    for (int i = 1, j = 0; i < n; i++) {
-        float x = p[i].x;
-        if (!isnan(x)) {
-            if (i - j > 1) {
-                d = (x - p[j].x) / (i - j);
-                for (j++; j < i; j++)
-                    p[j].x = p[j - 1].x + d;
-                p[j].x = x;
-            }
-            j = i;
+    if (!k->comp[1].sx && !k->comp[1].sy)
+        return 0; // not subsampled
+    if (s->transition == CUSTOM || s->transition == FADEGRAYS)
+        return AVERROR_BUG; // excluded by query_formats()
+    k->subsampled = true;
+
+    if (k->comp[1].plane == k->comp[2].plane) { // semi-planar: planar chroma scratch frames
+        const AVFilterLink *l = ctx->outputs[0];
+        const enum AVPixelFormat format = k->comp[1].sy ? (k->is_16 ? AV_PIX_FMT_YUV420P16 : AV_PIX_FMT_YUV420P)
+                                                       : (k->is_16 ? AV_PIX_FMT_YUV422P16 : AV_PIX_FMT_YUV422P);
+        for (int i = 0; i < 3; i++) {
+            if (!(k->uv[i] = av_frame_alloc()))
+                return AVERROR(ENOMEM);
+            k->uv[i]->format = format, k->uv[i]->width = l->w, k->uv[i]->height = l->h;
+            int ret = av_frame_get_buffer(k->uv[i], 0);
+            if (ret < 0)
+                return ret;
         }
     }
-    xe_debug(ctx, "easing = %s[%d](", s->easing_str, n);
-    for (int i = 0; i < n; i++)
-        av_log(ctx, AV_LOG_DEBUG, "%s%g %g", i ? ", " : "", a->points[i].x, a->points[i].y);
-    av_log(ctx, AV_LOG_DEBUG, ")\n");
     return 0;
 }
 
-// CSS cubic-bezier()
+////////////////////////////////////////////////////////////////////////////////
+// frame reuse
+////////////////////////////////////////////////////////////////////////////////
+
+// consecutive frames often have identical eased progress (CSS steps, linear() flats, clipped overshoots)
+// and with still inputs they render identically, so the last output is referenced instead of re-rendered
+
+// compare frame contents, by identity first
+static bool same_frame(const XFadeContext *s, const AVFrame *f, const AVFrame *g)
+{
+    if (!f || !g)
+        return false;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(f->format);
+    for (int p = 0; p < s->nb_planes; p++) {
+        const uint8_t *i = f->data[p], *j = g->data[p];
+        if (i == j && f->linesize[p] == g->linesize[p])
+            continue; // same buffer
+        const int bytes = av_image_get_linesize(f->format, f->width, p);
+        const int height = p == 1 || p == 2 ? AV_CEIL_RSHIFT(f->height, desc->log2_chroma_h) : f->height;
+        for (int y = 0; y < height; y++, i += f->linesize[p], j += g->linesize[p])
+            if (memcmp(i, j, bytes))
+                return false;
+    }
+    return true;
+}
+
+// drop cached frames
+static void xe_uncache(XFadeEasingContext *k)
+{
+    struct XFadeCache *c = &k->cache;
+    av_frame_free(&c->xf[0]);
+    av_frame_free(&c->xf[1]);
+    av_frame_free(&c->out);
+}
+
+// get new reference to last output if eased progress and inputs are unchanged, else NULL
+static AVFrame *xe_reuse_frame(XFadeContext *s, const ThreadData *td)
+{
+    const struct XFadeCache *c = &s->k->cache;
+    if (!c->out || td->progress != c->progress)
+        return NULL;
+    if (s->transition == CUSTOM || s->k->is_timed) // uses uneased progress
+        return NULL;
+    if (!same_frame(s, td->xf[0], c->xf[0]) || !same_frame(s, td->xf[1], c->xf[1]))
+        return NULL;
+    return av_frame_clone(c->out);
+}
+
+// true if the frame after the one at s->pts has the same eased progress, so may reuse its render
+static bool xe_progress_held(const XFadeContext *s, float progress)
+{
+    const XFadeEasingContext *k = s->k;
+    if (s->transition == CUSTOM || k->is_timed) // uses uneased progress
+        return false;
+    const int64_t i = xe_step_index(k, s->pts - s->start_pts);
+    return i >= 0 && i + 1 < k->nb_steps && k->steps[i + 1].p == progress;
+}
+
+// keep references to last render if the next frame may reuse it,
+// else hold nothing so the output stays writable downstream
+static int xe_cache_frame(XFadeContext *s, const ThreadData *td)
+{
+    struct XFadeCache *c = &s->k->cache;
+    xe_uncache(s->k);
+    if (s->passthrough || !xe_progress_held(s, td->progress)) // transition ended or progress moves on
+        return 0;
+    if (td->out->data[0] == td->xf[0]->data[0] || td->out->data[0] == td->xf[1]->data[0])
+        return 0; // rendered in place, input overwritten
+    c->progress = td->progress;
+    if (!(c->xf[0] = av_frame_clone(td->xf[0])) || !(c->xf[1] = av_frame_clone(td->xf[1]))
+                                               || !(c->out = av_frame_clone(td->out))) {
+        xe_uncache(s->k);
+        return AVERROR(ENOMEM);
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// in-place rendering
+////////////////////////////////////////////////////////////////////////////////
+
+// pointwise transitions compute each output pixel from the input pixels at the same position only,
+// so they can render over the second input frame when nothing else references it,
+// saving an output buffer and its memory traffic
+
+// true if each output pixel depends only on the input pixels at its position
+static bool xe_pointwise(const XFadeContext *s)
+{
+    const XFadeEasingContext *k = s->k;
+    if (k->xtransitionf) // extended, unless neighbouring pixels share a chroma sample
+        return !k->comp[1].sx && !k->comp[1].sy
+            && (k->xtransitionf == gl_blend || k->xtransitionf == gl_fadecolor || k->xtransitionf == gl_perlin
+                || k->xtransitionf == gl_randomsquares || k->xtransitionf == gl_windowblinds);
+    switch (s->transition) {
+    case FADE: case FADEBLACK: case FADEWHITE: case FADEGRAYS: case FADEFAST: case FADESLOW: case DISSOLVE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// new frame referencing the buffers of another, without its properties
+static AVFrame *buffer_frame(const AVFrame *f)
+{
+    AVFrame *out = av_frame_alloc();
+    if (!out)
+        return NULL;
+    out->format = f->format, out->width = f->width, out->height = f->height;
+    for (int i = 0; i < AV_NUM_DATA_POINTERS && f->buf[i]; i++) {
+        if (!(out->buf[i] = av_buffer_ref(f->buf[i]))) {
+            av_frame_free(&out);
+            return NULL;
+        }
+    }
+    memcpy(out->data, f->data, sizeof(out->data));
+    memcpy(out->linesize, f->linesize, sizeof(out->linesize));
+    return out;
+}
+
+// new frame on the buffers of the second input to render over, if pointwise and writable, else NULL;
+// not if the next frame may reuse the render, which needs the inputs intact
+static AVFrame *xe_inplace_frame(const XFadeContext *s, const ThreadData *td, AVFrame *b)
+{
+    if (!xe_pointwise(s) || !av_frame_is_writable(b) || xe_progress_held(s, td->progress))
+        return NULL;
+    return buffer_frame(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// input conversion
+////////////////////////////////////////////////////////////////////////////////
+
+// a second input whose pixel format differs from the first is converted to the output format
+// by the filter's own slice threads as its frames arrive, instead of by a separate format filter stage,
+// between RGB and YUV colour matrices BT.601, BT.709, BT.2020 and any bit depth or chroma subsampling;
+// with option resize, one whose size differs is resampled to the output size likewise;
+// still images (looped frames sharing a buffer) are converted once
+
+// pixel format layout for conversion
+typedef struct PixLayout {
+    struct Comp comp[4]; // in plane order (GBRA or YUVA)
+    int n, bytes, shift; // components, bytes per element, MSB alignment
+    float mv; // maximum value, 1 if float
+    bool is_rgb, is_float;
+    const YUVMatrix *yuv; // if not RGB
+} PixLayout;
+
+typedef struct ConvertData {
+    const AVFrame *in;
+    AVFrame *out;
+    PixLayout from, to;
+} ConvertData;
+
+// component layout in plane order (GBRA or YUVA), in elements
+static void comp_layout(const AVPixFmtDescriptor *desc, struct Comp *comp)
+{
+    const bool is_rgb = desc->flags & AV_PIX_FMT_FLAG_RGB;
+    const int bytes = (desc->comp[0].depth + 7) >> 3;
+    for (int p = 0; p < desc->nb_components; p++) {
+        const AVComponentDescriptor *c = &desc->comp[is_rgb && p < 3 ? (p + 1) % 3 : p]; // RGB is GBR
+        const bool chroma = p == 1 || p == 2;
+        comp[p] = (struct Comp) { c->plane, c->step / bytes, c->offset / bytes,
+                                  chroma ? desc->log2_chroma_w : 0, chroma ? desc->log2_chroma_h : 0 };
+    }
+}
+
+static void pixel_layout(PixLayout *l, enum AVPixelFormat format, const YUVMatrix *yuv)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(format);
+    comp_layout(desc, l->comp);
+    l->n = desc->nb_components;
+    l->bytes = (desc->comp[0].depth + 7) >> 3;
+    l->shift = desc->comp[0].shift;
+    l->is_rgb = desc->flags & AV_PIX_FMT_FLAG_RGB;
+    l->is_float = desc->flags & AV_PIX_FMT_FLAG_FLOAT;
+    l->mv = l->is_float ? 1 : (1 << desc->comp[0].depth) - 1;
+    l->yuv = yuv;
+}
+
+// normalised GBRA or YUVA pixel, chroma from its sample site, opaque if no alpha, neutral if grey
+static inline vec4 get_pixel(const AVFrame *f, const PixLayout *l, int x, int y)
+{
+    vec4 c = VEC4(0, P5f, P5f, 1);
+    for (int p = 0; p < l->n; p++) {
+        const struct Comp *m = &l->comp[p];
+        const uint8_t *d = f->data[m->plane] + (y >> m->sy) * f->linesize[m->plane]
+                         + ((x >> m->sx) * m->step + m->offset) * l->bytes;
+        c.p[p] = l->is_float ? *(const float *)d
+               : ((l->bytes == 1 ? *d : *(const uint16_t *)d) >> l->shift) / l->mv;
+    }
+    return c;
+}
+
+// store normalised pixel, chroma only at its sample site
+static inline void put_pixel(AVFrame *f, const PixLayout *l, int x, int y, vec4 c)
+{
+    for (int p = 0; p < l->n; p++) {
+        const struct Comp *m = &l->comp[p];
+        if ((x & ((1 << m->sx) - 1)) || (y & ((1 << m->sy) - 1)))
+            continue; // not a chroma site
+        uint8_t *d = f->data[m->plane] + (y >> m->sy) * f->linesize[m->plane]
+                   + ((x >> m->sx) * m->step + m->offset) * l->bytes;
+        if (l->is_float)
+            *(float *)d = c.p[p];
+        else if (l->bytes == 1)
+            *d = lrintf(av_clipf(c.p[p], 0, 1) * l->mv);
+        else
+            *(uint16_t *)d = lrintf(av_clipf(c.p[p], 0, 1) * l->mv) << l->shift;
+    }
+}
+
+static int convert_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    const ConvertData *cd = arg;
+    const PixLayout *from = &cd->from, *to = &cd->to;
+    const int slice_start = (cd->in->height *  jobnr   ) / nb_jobs;
+    const int slice_end   = (cd->in->height * (jobnr+1)) / nb_jobs;
+    for (int y = slice_start; y < slice_end; y++) {
+        for (int x = 0; x < cd->in->width; x++) {
+            vec4 c = get_pixel(cd->in, from, x, y);
+            if (from->is_rgb && !to->is_rgb)
+                c = gbr2yuv(c, to->yuv);
+            else if (!from->is_rgb && to->is_rgb)
+                c = yuv2gbr(c, from->yuv);
+            else if (!from->is_rgb && from->yuv != to->yuv)
+                c = gbr2yuv(yuv2gbr(c, from->yuv), to->yuv);
+            put_pixel(cd->out, to, x, y, c);
+        }
+    }
+    return 0;
+}
+
+// resample plane rows y0 to y1 of n-element pixels, sampling at pixel centres
+#define RESIZE_PLANE(bits, type, rnd)                                                \
+static void resize##bits##_plane(const uint8_t *src, int src_linesize, int iw, int ih, \
+                                 uint8_t *dst, int dst_linesize, int w, int h,       \
+                                 int n, int y0, int y1, bool bilinear)              \
+{                                                                                    \
+    const float fx = (float)iw / w, fy = (float)ih / h;                              \
+    for (int y = y0; y < y1; y++) {                                                  \
+        type *d = (type *)(dst + y * dst_linesize);                                  \
+        if (!bilinear) {                                                             \
+            const type *r = (const type *)(src + FFMIN((int)((y + P5f) * fy), ih - 1) * src_linesize); \
+            for (int x = 0; x < w; x++) {                                            \
+                const type *q = r + FFMIN((int)((x + P5f) * fx), iw - 1) * n;        \
+                for (int c = 0; c < n; c++)                                          \
+                    *d++ = q[c];                                                     \
+            }                                                                        \
+            continue;                                                                \
+        }                                                                            \
+        const float sy = av_clipf((y + P5f) * fy - P5f, 0, ih - 1);                  \
+        const int j = sy, j1 = FFMIN(j + 1, ih - 1);                                 \
+        const float v = sy - j;                                                      \
+        const type *r0 = (const type *)(src + j * src_linesize);                     \
+        const type *r1 = (const type *)(src + j1 * src_linesize);                    \
+        for (int x = 0; x < w; x++) {                                                \
+            const float sx = av_clipf((x + P5f) * fx - P5f, 0, iw - 1);              \
+            const int i = sx, i1 = FFMIN(i + 1, iw - 1);                             \
+            const float u = sx - i;                                                  \
+            for (int c = 0; c < n; c++) {                                            \
+                const float t = r0[i * n + c] + (r0[i1 * n + c] - r0[i * n + c]) * u; \
+                const float b = r1[i * n + c] + (r1[i1 * n + c] - r1[i * n + c]) * u; \
+                *d++ = t + (b - t) * v + rnd;                                        \
+            }                                                                        \
+        }                                                                            \
+    }                                                                                \
+}
+
+RESIZE_PLANE(8, uint8_t, P5f)
+RESIZE_PLANE(16, uint16_t, P5f)
+RESIZE_PLANE(32, float, 0)
+
+static int resize_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    const XFadeContext *s = ctx->priv;
+    const ConvertData *cd = arg;
+    const AVFrame *in = cd->in;
+    AVFrame *out = cd->out;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(out->format);
+    const int bytes = s->k->is_float ? 4 : s->depth > 8 ? 2 : 1;
+    const int slice_start = (out->height *  jobnr   ) / nb_jobs;
+    const int slice_end   = (out->height * (jobnr+1)) / nb_jobs;
+    for (int p = 0; p < s->nb_planes; p++) {
+        int n = 1, sx = 0, sy = 0; // elements per pixel, log2 subsampling
+        for (int c = 0; c < desc->nb_components; c++) {
+            if (desc->comp[c].plane != p)
+                continue;
+            n = FFMAX(n, desc->comp[c].step / bytes);
+            if (c == 1 || c == 2)
+                sx = desc->log2_chroma_w, sy = desc->log2_chroma_h;
+        }
+        const int iw = AV_CEIL_RSHIFT(in->width, sx), ih = AV_CEIL_RSHIFT(in->height, sy);
+        const int w = AV_CEIL_RSHIFT(out->width, sx), h = AV_CEIL_RSHIFT(out->height, sy);
+        const int y0 = AV_CEIL_RSHIFT(slice_start, sy), y1 = AV_CEIL_RSHIFT(slice_end, sy);
+        const bool bilinear = s->resize == RESIZE_BILINEAR;
+        if (bytes == 1)
+            resize8_plane(in->data[p], in->linesize[p], iw, ih, out->data[p], out->linesize[p], w, h, n, y0, y1, bilinear);
+        else if (bytes == 2)
+            resize16_plane(in->data[p], in->linesize[p], iw, ih, out->data[p], out->linesize[p], w, h, n, y0, y1, bilinear);
+        else
+            resize32_plane(in->data[p], in->linesize[p], iw, ih, out->data[p], out->linesize[p], w, h, n, y0, y1, bilinear);
+    }
+    return 0;
+}
+
+// convert then resample a frame into a new one, of the output format at the output or input size
+static AVFrame *convert_frame(AVFilterContext *ctx, const AVFrame *in, bool convert, bool resize)
+{
+    const XFadeContext *s = ctx->priv;
+    AVFilterLink *outlink = ctx->outputs[0];
+    const int nb_threads = ff_filter_get_nb_threads(ctx);
+    ConvertData cd = { .in = in };
+    AVFrame *t = NULL; // converted at input size
+    if (convert) {
+        if (resize) {
+            if (!(t = av_frame_alloc()))
+                return NULL;
+            t->format = outlink->format, t->width = in->width, t->height = in->height;
+            if (av_frame_get_buffer(t, 0) < 0) {
+                av_frame_free(&t);
+                return NULL;
+            }
+        } else if (!(t = ff_get_video_buffer(outlink, outlink->w, outlink->h)))
+            return NULL;
+        pixel_layout(&cd.from, in->format, yuv_matrix(in->colorspace));
+        pixel_layout(&cd.to, outlink->format, s->k->yuv);
+        cd.out = t;
+        ff_filter_execute(ctx, convert_slice, &cd, NULL, FFMIN(in->height, nb_threads));
+        if (!resize)
+            return t;
+        cd.in = t;
+    }
+    AVFrame *out = ff_get_video_buffer(outlink, outlink->w, outlink->h);
+    if (out) {
+        cd.out = out;
+        ff_filter_execute(ctx, resize_slice, &cd, NULL, FFMIN(outlink->h, nb_threads));
+    }
+    av_frame_free(&t);
+    return out;
+}
+
+// replace a frame of different format or size by one converted to the output format and size, freeing it on error
+static int xe_convert_frame(AVFilterContext *ctx, AVFrame **f)
+{
+    XFadeContext *s = ctx->priv;
+    struct XFadeConvert *r = &s->k->converted;
+    AVFilterLink *outlink = ctx->outputs[0];
+    AVFrame *in = *f, *out;
+    const bool convert = in->format != outlink->format;
+    const bool resize = in->width != outlink->w || in->height != outlink->h;
+    if (!convert && !resize)
+        return 0;
+    if (r->in && r->in->data[0] == in->data[0] && r->in->format == in->format
+              && r->in->width == in->width && r->in->height == in->height)
+        out = av_frame_clone(r->out); // same still image, buffer held by r->in
+    else {
+        av_frame_free(&r->in);
+        av_frame_free(&r->out);
+        if ((out = convert_frame(ctx, in, convert, resize))
+            && (!(r->in = av_frame_clone(in)) || !(r->out = av_frame_clone(out)))) {
+            av_frame_free(&r->in);
+            av_frame_free(&out);
+        }
+    }
+    if (!out) {
+        av_frame_free(f);
+        return AVERROR(ENOMEM);
+    }
+    av_frame_copy_props(out, in);
+#if LIBAVFILTER_VERSION_INT >= AV_VERSION_INT(10, 4, 100)
+    if (convert)
+        out->colorspace = outlink->colorspace, out->color_range = outlink->color_range; // v7.1
+#endif
+    av_frame_free(f);
+    *f = out;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// slice scheduling
+////////////////////////////////////////////////////////////////////////////////
+
+// per-row cost is often uneven (gl_Swirl radius, gl_doorway slit, gl_SimplePageCurl curl zone),
+// so instead of one equal band per thread, threads pull small row chunks from a shared counter
+// and the chunk size adapts to the measured row cost (option chunk: -1 equal bands (default), 0 auto, else rows)
+
+// transitions that gather from a 2-D footprint (gl_CrossZoom rays, gl_kaleidoscope, gl_Swirl)
+// stream whole rows of both inputs through cache, so they render in square tiles instead,
+// keeping source reads cache-resident (option tile: -1 rows, 0 auto for gather-heavy transitions, else size)
+
+#define CHUNK_US 50 /* target chunk duration, microseconds */
+#define TILE_SIZE 64 /* default tile width and height */
+
+// chunk queue over rows of one or more frames
+typedef struct {
+    const ThreadData *td[MAX_BATCH]; // frames to render
+    int nb; // number of frames
+    int start, rows; // row range in each frame
+    int chunk, chunks; // rows per chunk (tile size if tiled), chunks per frame
+    int cols; // tile columns, 0 for row chunks
+    atomic_int next; // next chunk to render
+} SliceQueue;
+
+// render chunks until none remain
+static int queue_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    const XFadeContext *s = ctx->priv;
+    SliceQueue *q = arg;
+    const int total = q->nb * q->chunks;
+
+    for (int i; (i = atomic_fetch_add_explicit(&q->next, 1, memory_order_relaxed)) < total; ) {
+        const ThreadData *td = q->td[i / q->chunks];
+        const int c = i % q->chunks, row = q->cols ? c / q->cols : c;
+        const int slice_start = q->start + row * q->chunk;
+        const int slice_end = FFMIN(slice_start + q->chunk, q->start + q->rows);
+        if (q->cols) { // tile
+            const int x = (c % q->cols) * q->chunk;
+            s->k->regionf(ctx, td->xf[0], td->xf[1], td->out, td->progress,
+                          x, FFMIN(x + q->chunk, td->out->width), slice_start, slice_end);
+        } else
+            s->transitionf(ctx, td->xf[0], td->xf[1], td->out, td->progress, slice_start, slice_end, jobnr);
+    }
+
+    return 0;
+}
+
+// tile size for the transition, 0 for row chunks
+static int xe_tile_size(const XFadeContext *s)
+{
+    const XFadeEasingContext *k = s->k;
+    return !k->regionf || s->tile < 0 ? 0 : s->tile ? s->tile : k->gather ? TILE_SIZE : 0;
+}
+
+// render rows start to end of nb frames
+static void xe_execute(AVFilterContext *ctx, const ThreadData *const *td, int nb, int start, int end)
+{
+    const XFadeContext *s = ctx->priv;
+    XFadeEasingContext *k = s->k;
+    const int threads = ff_filter_get_nb_threads(ctx), rows = end - start;
+    SliceQueue q = { .nb = nb, .start = start, .rows = rows };
+    if (rows <= 0)
+        return;
+    memcpy(q.td, td, nb * sizeof(*td));
+
+    const int tile = xe_tile_size(s);
+    int chunk = s->chunk;
+    if (tile) { // square tiles
+        const int width = td[0]->out->width;
+        q.chunk = tile;
+        q.cols = (width + tile - 1) / tile;
+        q.chunks = q.cols * ((rows + tile - 1) / tile);
+    } else {
+        if (chunk < 0) // equal bands, one per thread across all frames
+            chunk = (rows * nb + threads - 1) / threads;
+        else if (!chunk) // adaptive
+            chunk = k->chunk ? k->chunk : rows / (threads * 8);
+        q.chunk = av_clip(chunk, 1, rows);
+        q.chunks = (rows + q.chunk - 1) / q.chunk;
+    }
+    atomic_init(&q.next, 0);
+
+    const int jobs = FFMIN(threads, nb * q.chunks);
+    const int64_t t = s->chunk || tile || jobs < 2 ? 0 : av_gettime_relative();
+    if (k->uv[0]) // semi-planar xfade transition, nb is 1
+        for (int i = 0; i < 2; i++)
+            xe_swap_chroma(ctx, td[0]->xf[i], k->uv[i], 0, td[0]->out->height, false);
+    ff_filter_execute(ctx, queue_slice, &q, NULL, jobs);
+    if (k->uv[0])
+        xe_swap_chroma(ctx, td[0]->out, k->uv[2], start, end, true);
+    if (!t)
+        return;
+
+    // feedback: aim for CHUNK_US per chunk within enough chunks to balance the threads
+    const float us = (float)(av_gettime_relative() - t) * jobs / (nb * rows); // per row per thread
+    const int fair = FFMAX(1, nb * rows / (threads * 8));
+    chunk = us > 0 ? av_clip(lrintf(CHUNK_US / us), 1, fair) : fair;
+    k->chunk = k->chunk ? (k->chunk + chunk + 1) / 2 : chunk; // smoothed
+}
+
+// render whole frame by chunk queue, returns false for equal bands with no tiles
+static bool xe_render_chunks(AVFilterContext *ctx, const ThreadData *td)
+{
+    const XFadeContext *s = ctx->priv;
+    if (s->chunk < 0 && !xe_tile_size(s) && !s->k->uv[0]) // semi-planar needs chroma swaps
+        return false;
+    xe_execute(ctx, &td, 1, 0, td->out->height);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// endpoint frames
+////////////////////////////////////////////////////////////////////////////////
+
+// at eased progress 1 and 0 (first and last frames, clipped overshoots) most transitions output
+// one input unchanged, so such frames reference that input instead of rendering
+
+typedef enum { ENDPOINT_FROM = 1, ENDPOINT_TO = 2 } EndpointFlags; // input shown unchanged at progress 1, 0
+
+// xfade transitions exact at an endpoint for every frame size, depth and plane layout;
+// those absent (circlecrop, rectcrop, circleopen, circleclose, custom) and extended transitions are rendered
+static const uint8_t xe_endpoints[NB_TRANSITIONS] = {
+    [FADE] = ENDPOINT_FROM | ENDPOINT_TO, [FADEBLACK] = ENDPOINT_FROM | ENDPOINT_TO,
+    [FADEWHITE] = ENDPOINT_FROM | ENDPOINT_TO, [FADEGRAYS] = ENDPOINT_FROM | ENDPOINT_TO,
+    [FADEFAST] = ENDPOINT_FROM | ENDPOINT_TO, [FADESLOW] = ENDPOINT_FROM | ENDPOINT_TO,
+    [WIPELEFT] = ENDPOINT_FROM, [WIPERIGHT] = ENDPOINT_TO, [WIPEUP] = ENDPOINT_FROM, [WIPEDOWN] = ENDPOINT_TO,
+    [WIPETL] = ENDPOINT_FROM, [WIPETR] = ENDPOINT_TO, [WIPEBL] = ENDPOINT_TO, [WIPEBR] = ENDPOINT_TO,
+    [SLIDELEFT] = ENDPOINT_FROM | ENDPOINT_TO, [SLIDERIGHT] = ENDPOINT_FROM | ENDPOINT_TO,
+    [SLIDEUP] = ENDPOINT_FROM | ENDPOINT_TO, [SLIDEDOWN] = ENDPOINT_FROM | ENDPOINT_TO,
+    [SMOOTHLEFT] = ENDPOINT_FROM | ENDPOINT_TO, [SMOOTHRIGHT] = ENDPOINT_FROM | ENDPOINT_TO,
+    [SMOOTHUP] = ENDPOINT_FROM | ENDPOINT_TO, [SMOOTHDOWN] = ENDPOINT_FROM | ENDPOINT_TO,
+    [VERTOPEN] = ENDPOINT_FROM | ENDPOINT_TO, [VERTCLOSE] = ENDPOINT_FROM | ENDPOINT_TO,
+    [HORZOPEN] = ENDPOINT_FROM | ENDPOINT_TO, [HORZCLOSE] = ENDPOINT_FROM | ENDPOINT_TO,
+    [DIAGTL] = ENDPOINT_FROM | ENDPOINT_TO, [DIAGTR] = ENDPOINT_FROM | ENDPOINT_TO,
+    [DIAGBL] = ENDPOINT_FROM | ENDPOINT_TO, [DIAGBR] = ENDPOINT_FROM | ENDPOINT_TO,
+    [HLSLICE] = ENDPOINT_FROM | ENDPOINT_TO, [HRSLICE] = ENDPOINT_FROM | ENDPOINT_TO,
+    [VUSLICE] = ENDPOINT_FROM | ENDPOINT_TO, [VDSLICE] = ENDPOINT_FROM | ENDPOINT_TO,
+    [HLWIND] = ENDPOINT_FROM | ENDPOINT_TO, [HRWIND] = ENDPOINT_FROM | ENDPOINT_TO,
+    [VUWIND] = ENDPOINT_FROM | ENDPOINT_TO, [VDWIND] = ENDPOINT_FROM | ENDPOINT_TO,
+    [COVERLEFT] = ENDPOINT_FROM | ENDPOINT_TO, [COVERRIGHT] = ENDPOINT_FROM | ENDPOINT_TO,
+    [COVERUP] = ENDPOINT_FROM | ENDPOINT_TO, [COVERDOWN] = ENDPOINT_FROM | ENDPOINT_TO,
+    [REVEALLEFT] = ENDPOINT_FROM | ENDPOINT_TO, [REVEALRIGHT] = ENDPOINT_FROM | ENDPOINT_TO,
+    [REVEALUP] = ENDPOINT_FROM | ENDPOINT_TO, [REVEALDOWN] = ENDPOINT_FROM | ENDPOINT_TO,
+    [DISSOLVE] = ENDPOINT_FROM | ENDPOINT_TO, [PIXELIZE] = ENDPOINT_FROM | ENDPOINT_TO,
+    [HBLUR] = ENDPOINT_FROM | ENDPOINT_TO, [RADIAL] = ENDPOINT_FROM, [DISTANCE] = ENDPOINT_TO,
+    [SQUEEZEH] = ENDPOINT_TO, [SQUEEZEV] = ENDPOINT_TO, [ZOOMIN] = ENDPOINT_TO,
+};
+
+// new reference to the input shown at eased progress 1 or 0, else NULL
+static AVFrame *xe_endpoint_frame(AVFilterContext *ctx, const ThreadData *td)
+{
+    const XFadeContext *s = ctx->priv;
+    if (td->progress != 0 && td->progress != 1)
+        return NULL;
+    if (s->k->xtransitionf) // extended, s->transition is stale
+        return NULL;
+    const int i = td->progress == 0; // input shown
+    return xe_endpoints[s->transition] & (i ? ENDPOINT_TO : ENDPOINT_FROM) ? buffer_frame(td->xf[i]) : NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// incremental rendering
+////////////////////////////////////////////////////////////////////////////////
+
+// with still inputs, row-separable transitions only change the rows whose output depends on progress
+// between the last render and this, so the last output is copied and just those rows are re-rendered;
+// only vertical wipes and horizontal opens/closes qualify, others change every row (wipeleft, slides)
+// or are not bounded by progress alone, and config_xfade_easing() warns that they render in full
+
+// row range, end exclusive
+typedef struct {
+    int start, end;
+} RowBand;
+
+// conservative row bands that change between eased progress p0 and p1, returns band count, 0 if unknown
+static int dirty_rows(const XFadeContext *s, int h, float p0, float p1, RowBand band[2])
+{
+    const float lo = FFMIN(p0, p1), hi = FFMAX(p0, p1), h2 = h / 2.f;
+    float z0, z1; // row bounds (wipes) or distance bounds from centre (horz open/close)
+    if (s->k->xtransitionf) // extended, s->transition is stale
+        return 0;
+    switch (s->transition) {
+    case WIPEUP:    z0 = h * lo,       z1 = h * hi;       break;
+    case WIPEDOWN:  z0 = h * (1 - hi), z1 = h * (1 - lo); break;
+    case WIPETL:
+    case WIPETR:    z0 = 0,            z1 = h * hi;       break;
+    case WIPEBL:
+    case WIPEBR:    z0 = h * (1 - hi), z1 = h;            break;
+    case HORZOPEN:  z0 = h2 * (1 - 2 * hi), z1 = h2 * (2 - 2 * lo); break; // smoothstep edges
+    case HORZCLOSE: z0 = h2 * (2 * lo - 1), z1 = h2 * 2 * hi;       break;
+    default: return 0; // not row separable, or not by progress alone
+    }
+    int nb = 1;
+    if (s->transition == HORZOPEN || s->transition == HORZCLOSE) { // symmetric about centre
+        z0 = FFMAX(z0, 0);
+        band[0] = (RowBand) { h2 - z1 - 1, h2 - z0 + 2 };
+        band[1] = (RowBand) { h2 + z0 - 1, h2 + z1 + 2 };
+        if (band[0].end < band[1].start)
+            nb = 2;
+        else
+            band[0].end = band[1].end; // merge
+    } else
+        band[0] = (RowBand) { (int)z0 - 1, (int)z1 + 2 }; // margin for truncation
+    for (int i = 0; i < nb; i++)
+        band[i].start = av_clip(band[i].start, 0, h), band[i].end = av_clip(band[i].end, 0, h);
+    return nb;
+}
+
+// re-render changed rows over a copy of the last output if inputs are still, returns false if not applicable
+static bool xe_render_dirty(AVFilterContext *ctx, const ThreadData *td)
+{
+    const XFadeContext *s = ctx->priv;
+    const struct XFadeCache *c = &s->k->cache;
+    RowBand band[2];
+    if (!s->incremental || !c->out)
+        return false;
+    const int nb = dirty_rows(s, td->out->height, c->progress, td->progress, band);
+    if (!nb)
+        return false;
+    if (!same_frame(s, td->xf[0], c->xf[0]) || !same_frame(s, td->xf[1], c->xf[1]))
+        return false;
+    if (av_frame_copy(td->out, c->out) < 0)
+        return false;
+    for (int i = 0; i < nb; i++)
+        xe_execute(ctx, &td, 1, band[i].start, band[i].end);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// frame-parallel rendering
+////////////////////////////////////////////////////////////////////////////////
+
+// each transition frame depends only on its inputs and eased progress, so with option batch > 1
+// queued input pairs are rendered together by one threaded execute whose jobs span frames × row chunks,
+// amortising the execute barrier over small frames, then emitted in pts order
+
+// true if transition frames can render out of sequence
+static bool xe_batchable(const XFadeContext *s)
+{
+    return s->batch > 1 && s->transition != CUSTOM && !s->k->is_timed // not using s->pts or expr state
+                        && !s->k->uv[0]; // nor semi-planar scratch frames
+}
+
+// true while a batch holds frame pairs or outputs, so vf_xfade:xfade_activate() resumes it first
+static bool xe_batch_pending(const XFadeContext *s)
+{
+    return s->k && s->k->batch.n;
+}
+
+// free held frames and reset
+static void batch_free(struct XFadeBatch *b)
+{
+    for (int i = 0; i < b->n; i++) {
+        av_frame_free(&b->xf[i][0]);
+        av_frame_free(&b->xf[i][1]);
+        av_frame_free(&b->out[i]);
+    }
+    b->n = 0, b->next = -1, b->end = false;
+}
+
+// render held pairs, reusing endpoint inputs, the last render or the previous frame where unchanged
+static int render_batch(AVFilterContext *ctx)
+{
+    XFadeContext *s = ctx->priv;
+    struct XFadeBatch *b = &s->k->batch;
+    AVFilterLink *outlink = ctx->outputs[0];
+    int nr = 0, ret;
+
+    for (int i = 0; i < b->n; i++) {
+        ThreadData *td = &b->td[i];
+        s->pts = b->xf[i][0]->pts;
+        xe_thread_data(s, b->xf[i][0], b->xf[i][1], td);
+        if ((b->out[i] = xe_endpoint_frame(ctx, td))) // an input unchanged
+            continue;
+        if (i == 0)
+            b->out[i] = xe_reuse_frame(s, td); // unchanged since last batch
+        else if (td->progress == td[-1].progress && same_frame(s, td->xf[0], td[-1].xf[0])
+                                                 && same_frame(s, td->xf[1], td[-1].xf[1]))
+            continue; // duplicate of previous, cloned below
+        if (b->out[i])
+            continue;
+        if (!(b->out[i] = ff_get_video_buffer(outlink, outlink->w, outlink->h)))
+            return AVERROR(ENOMEM);
+        td->out = b->out[i];
+        b->r[nr++] = td;
+    }
+    if (nr) {
+        xe_execute(ctx, b->r, nr, 0, outlink->h);
+        if ((ret = xe_cache_frame(s, b->r[nr - 1])) < 0)
+            return ret;
+    }
+    for (int i = 1; i < b->n; i++)
+        if (!b->out[i] && !(b->out[i] = av_frame_clone(b->out[i - 1])))
+            return AVERROR(ENOMEM);
+    b->next = 0;
+    return 0;
+}
+
+// emit the next rendered frame if the output wants one
+static int emit_batch(AVFilterContext *ctx)
+{
+    XFadeContext *s = ctx->priv;
+    struct XFadeBatch *b = &s->k->batch;
+    AVFilterLink *outlink = ctx->outputs[0];
+    if (!ff_outlink_frame_wanted(outlink))
+        return 0; // resumed on request
+    const int i = b->next++;
+    AVFrame *out = b->out[i];
+    b->out[i] = NULL;
+    av_frame_copy_props(out, b->xf[i][0]);
+    out->pts = b->xf[i][0]->pts;
+    xe_frame_metadata(out, &b->td[i]);
+    if (b->next == b->n)
+        batch_free(b); // done, inputs released
+    else
+        ff_filter_set_ready(ctx, 100); // more to emit once wanted
+    return ff_filter_frame(outlink, out);
+}
+
+// consume queued frame pairs into the batch until it is full, the transition ends or an input ends,
+// requesting more from inputs with nothing queued, then render them all at once and emit in pts order;
+// an input status is only read (not handled) here, so vf_xfade:xfade_activate() handles it after the flush
+static int xe_batch_frames(AVFilterContext *ctx)
+{
+    XFadeContext *s = ctx->priv;
+    struct XFadeBatch *b = &s->k->batch;
+    AVFilterLink *in_a = ctx->inputs[0], *in_b = ctx->inputs[1], *outlink = ctx->outputs[0];
+    int ret;
+
+    if (b->n && b->next >= 0)
+        return emit_batch(ctx);
+
+    if (!b->n)
+        b->next = -1;
+    while (b->n < s->batch && !b->end && ff_inlink_check_available_frame(in_a) && ff_inlink_check_available_frame(in_b)) {
+        AVFrame **xf = b->xf[b->n];
+        if ((ret = ff_inlink_consume_frame(in_a, &xf[0])) < 0)
+            return ret;
+        b->n++; // held, freed on failure
+        if ((ret = ff_inlink_consume_frame(in_b, &xf[1])) < 0 || (ret = xe_convert_frame(ctx, &xf[1])) < 0)
+            return ret;
+        if (s->inputs_offset_pts == AV_NOPTS_VALUE)
+            s->inputs_offset_pts = xf[0]->pts - xf[1]->pts;
+        b->end = xf[0]->pts - s->start_pts > s->duration_pts; // transition ends here
+    }
+
+    if (b->n < s->batch && !b->end) { // more may come unless an input has ended
+        bool ended = false;
+        for (int i = 0; i < 2; i++) {
+            int status;
+            int64_t pts;
+            if (!ff_inlink_check_available_frame(ctx->inputs[i]) && ff_inlink_acknowledge_status(ctx->inputs[i], &status, &pts))
+                ended = true; // flush, status is returned again to xfade_activate()
+        }
+        if (!ended) {
+            if (!ff_outlink_frame_wanted(outlink))
+                return 0; // resumed on request
+            for (int i = 0; i < 2; i++)
+                if (!ff_inlink_check_available_frame(ctx->inputs[i]))
+                    ff_inlink_request_frame(ctx->inputs[i]);
+            return 0;
+        }
+    }
+
+    if (b->end) { // report EOF to first input as it is no longer needed
+        s->status[0] = AVERROR_EOF;
+        ff_inlink_set_status(in_a, AVERROR_EOF);
+        s->passthrough = 1;
+    }
+    if ((ret = render_batch(ctx)) < 0)
+        return ret;
+    return emit_batch(ctx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// slideshow
+////////////////////////////////////////////////////////////////////////////////
+
+// with option inputs > 2, one filter instance cuts from each input to the next,
+// taking |-separated per-cut lists of transitions, easings, offsets and durations,
+// so each frame is forwarded once instead of through a chain of xfade filters,
+// and only the active cut renders
+
+typedef struct XFadeCut { // a configured transition
+    XFadeEasingContext *k;
+    AVExpr **e;
+    void (*transitionf)(AVFilterContext *ctx, const AVFrame *a, const AVFrame *b, AVFrame *out, float progress,
+                        int slice_start, int slice_end, int jobnr);
+    int transition, reverse;
+    char *transition_str, *easing_str; // list items, referenced by parsed args
+    int64_t offset, duration; // AV_TIME_BASE
+    int64_t offset_pts, duration_pts; // output time base
+} XFadeCut;
+
+typedef struct XFadeSlideshow {
+    XFadeCut *cuts; // alloc
+    int nb_cuts, cut; // current cut, from input cut to input cut + 1
+    int64_t origin_pts; // first output pts
+    int64_t *offset_pts; // input to output pts offsets, AV_NOPTS_VALUE until known, alloc
+} XFadeSlideshow;
+
+static int config_output(AVFilterLink *outlink);
+static int xfade_frame(AVFilterContext *ctx, AVFrame *a, AVFrame *b);
+
+// item i of a |-separated list, the last if fewer, NULL if none or empty
+static char *list_item(const char *list, int i)
+{
+    if (!list)
+        return NULL;
+    for (const char *t; i-- && (t = next_item(list)); list = t);
+    const size_t n = strcspn(list, "|");
+    return n ? av_strndup(list, n) : NULL;
+}
+
+// number of items in a |-separated list
+static int list_count(const char *list)
+{
+    int n = 0;
+    for (const char *t = list; t; t = next_item(t))
+        n++;
+    return n;
+}
+
+// make cut i current, i == nb_cuts being after the final cut, whose context still converts frames
+static void slideshow_cut(XFadeContext *s, int i)
+{
+    XFadeSlideshow *show = s->show;
+    const XFadeCut *c = &show->cuts[FFMIN(i, show->nb_cuts - 1)];
+    if (s->k && s->k != c->k) { // drop frames held by previous cut
+        xe_uncache(s->k);
+        av_frame_free(&s->k->converted.in);
+        av_frame_free(&s->k->converted.out);
+    }
+    show->cut = i;
+    s->k = c->k, s->e = c->e;
+    s->transitionf = c->transitionf, s->transition = c->transition, s->reverse = c->reverse;
+    s->duration_pts = c->duration_pts;
+    s->start_pts = show->origin_pts == AV_NOPTS_VALUE ? AV_NOPTS_VALUE : show->origin_pts + c->offset_pts;
+}
+
+// configure cut i through vf_xfade:config_output() with its list items, options unchanged
+static int config_cut(AVFilterLink *outlink, XFadeCut *c, int i)
+{
+    AVFilterContext *ctx = outlink->src;
+    XFadeContext *s = ctx->priv;
+    char *transition_str = s->transition_str, *easing_str = s->easing_str; // options
+    const int reverse = s->reverse;
+    const int64_t offset = s->offset, duration = s->duration;
+
+    s->offset = c->offset, s->duration = c->duration;
+    s->transition_str = c->transition_str = list_item(transition_str, i);
+    s->easing_str = c->easing_str = list_item(easing_str, i);
+    s->k = NULL, s->e = NULL;
+    int ret = config_output(outlink);
+    c->k = s->k, c->e = s->e;
+    c->transitionf = s->transitionf, c->transition = s->transition, c->reverse = s->reverse;
+    c->offset_pts = av_rescale_q(c->offset, AV_TIME_BASE_Q, outlink->time_base);
+    c->duration_pts = s->duration_pts;
+    s->transition_str = transition_str, s->easing_str = easing_str, s->reverse = reverse;
+    s->offset = offset, s->duration = duration;
+    if (ret >= 0)
+        xe_debug(ctx, "cut %d: transition=%s easing=%s offset=%gs duration=%gs\n", i, c->transition_str, c->easing_str,
+                 (double)c->offset / AV_TIME_BASE, (double)c->duration / AV_TIME_BASE);
+    return ret;
+}
+
+// free cut context and list items
+static void free_cut(XFadeCut *c)
+{
+    xe_data_free(c->k);
+    free_exprs(&c->e);
+    av_free(c->transition_str);
+    av_free(c->easing_str);
+}
+
+// time and configure each cut
+static int xe_config_slideshow(AVFilterLink *outlink)
+{
+    AVFilterContext *ctx = outlink->src;
+    XFadeContext *s = ctx->priv;
+    XFadeSlideshow *show;
+    AVFilterLink *in0 = ctx->inputs[0];
+    int ret = 0;
+
+    for (int i = 2; i < ctx->nb_inputs; i++) {
+        const AVFilterLink *in = ctx->inputs[i];
+        if (av_cmp_q(in->time_base, in0->time_base) || av_cmp_q(ff_filter_link(ctx->inputs[i])->frame_rate,
+                                                                ff_filter_link(in0)->frame_rate))
+            return xe_error(ctx, "input %d time base or frame rate differs from the first input\n", i);
+        if ((in->w != in0->w || in->h != in0->h) && !s->resize)
+            return xe_error(ctx, "input %d size differs from the first input\n", i);
+    }
+
+    if (!(show = s->show = av_mallocz(sizeof(*show))))
+        return AVERROR(ENOMEM);
+    show->nb_cuts = ctx->nb_inputs - 1;
+    show->origin_pts = AV_NOPTS_VALUE;
+    if (!(show->cuts = av_calloc(show->nb_cuts, sizeof(*show->cuts)))
+        || !(show->offset_pts = av_malloc_array(ctx->nb_inputs, sizeof(*show->offset_pts))))
+        return AVERROR(ENOMEM);
+    show->offset_pts[0] = 0;
+    for (int i = 1; i < ctx->nb_inputs; i++)
+        show->offset_pts[i] = AV_NOPTS_VALUE;
+
+    const int nb_offsets = s->offsets_str ? list_count(s->offsets_str) : 0;
+    int64_t offset = 0, hold = s->offset, duration = s->duration; // of previous cut
+    for (int i = 0; i < show->nb_cuts && ret >= 0; i++) {
+        XFadeCut *c = &show->cuts[i];
+        char *t = list_item(s->offsets_str, i), *d = list_item(s->durations_str, i);
+        const int64_t last = duration;
+        int64_t us;
+        if (d) { // else duration option, or last listed
+            if ((ret = av_parse_time(&us, d, 1)) < 0)
+                ret = xe_error(ctx, "invalid duration %s\n", d);
+            else
+                duration = us;
+        }
+        if (ret >= 0 && t && i < nb_offsets) {
+            if ((ret = av_parse_time(&us, t, 1)) < 0)
+                ret = xe_error(ctx, "invalid offset %s\n", t);
+            else
+                offset = us;
+        } else // unlisted: previous cut end plus first cut offset
+            offset = i ? offset + last + hold : hold;
+        if (!i)
+            hold = offset;
+        av_free(t);
+        av_free(d);
+        c->offset = offset, c->duration = duration;
+        if (ret >= 0)
+            ret = config_cut(outlink, c, i);
+    }
+    s->k = NULL, s->e = NULL; // held by cuts
+    if (ret >= 0)
+        slideshow_cut(s, 0);
+    return ret;
+}
+
+// consume frame from input i, converted to the output format and size, pts on output timeline
+static int consume_frame(AVFilterContext *ctx, int i, AVFrame **f)
+{
+    const XFadeContext *s = ctx->priv;
+    int ret = ff_inlink_consume_frame(ctx->inputs[i], f);
+    if (ret >= 0 && (ret = xe_convert_frame(ctx, f)) >= 0)
+        (*f)->pts += s->show->offset_pts[i];
+    return ret;
+}
+
+// vf_xfade:xfade_activate() for a slideshow
+static int xe_slideshow_activate(AVFilterContext *ctx)
+{
+    XFadeContext *s = ctx->priv;
+    XFadeSlideshow *show = s->show;
+    const int c = show->cut, last = c == show->nb_cuts; // last is the input after the final cut
+    AVFilterLink *in_a = ctx->inputs[c], *in_b = last ? NULL : ctx->inputs[c + 1], *outlink = ctx->outputs[0];
+    AVFrame *a, *b;
+    int64_t status_pts;
+    int status, ret;
+
+    FF_FILTER_FORWARD_STATUS_BACK_ALL(outlink, ctx);
+
+    if (ff_inlink_check_available_frame(in_a)) {
+        a = ff_inlink_peek_frame(in_a, 0);
+        if (show->offset_pts[c] == AV_NOPTS_VALUE) // previous input ended before the cut
+            show->offset_pts[c] = s->pts - a->pts;
+        s->pts = a->pts + show->offset_pts[c];
+        if (show->origin_pts == AV_NOPTS_VALUE) {
+            show->origin_pts = s->pts;
+            slideshow_cut(s, c); // cut start
+        }
+
+        if (last || s->pts < s->start_pts) { // forward
+            s->passthrough = 1;
+            if ((ret = consume_frame(ctx, c, &a)) < 0)
+                return ret;
+            xe_passthrough_metadata(s, a, last);
+            return ff_filter_frame(outlink, a);
+        }
+        s->passthrough = 0;
+
+        if (ff_inlink_check_available_frame(in_b)) {
+            if (show->offset_pts[c + 1] == AV_NOPTS_VALUE)
+                show->offset_pts[c + 1] = s->pts - ff_inlink_peek_frame(in_b, 0)->pts;
+            if ((ret = consume_frame(ctx, c, &a)) < 0)
+                return ret;
+            if ((ret = consume_frame(ctx, c + 1, &b)) < 0) {
+                av_frame_free(&a);
+                return ret;
+            }
+            const bool end = s->pts - s->start_pts > s->duration_pts;
+            if (end) { // first input of cut no longer needed
+                ff_inlink_set_status(in_a, AVERROR_EOF);
+                s->passthrough = 1;
+            }
+            ret = xfade_frame(ctx, a, b);
+            av_frame_free(&a);
+            av_frame_free(&b);
+            if (end)
+                slideshow_cut(s, c + 1);
+            return ret;
+        }
+
+        if (ff_inlink_acknowledge_status(in_b, &status, &status_pts)) { // next input ended before its cut
+            ff_outlink_set_status(outlink, status, s->pts);
+            return 0;
+        }
+        if (ff_outlink_frame_wanted(outlink))
+            ff_inlink_request_frame(in_b);
+        return 0;
+    }
+
+    if (ff_inlink_acknowledge_status(in_a, &status, &status_pts)) {
+        if (show->offset_pts[c] != AV_NOPTS_VALUE)
+            s->pts = status_pts + show->offset_pts[c];
+        if (last) {
+            ff_outlink_set_status(outlink, status, s->pts);
+            return 0;
+        }
+        slideshow_cut(s, c + 1); // cut straight to next input
+        ff_filter_set_ready(ctx, 100);
+        return 0;
+    }
+
+    if (ff_outlink_frame_wanted(outlink))
+        ff_inlink_request_frame(in_a);
+    return FFERROR_NOT_READY;
+}
+
+// free cuts
+static void xe_slideshow_free(XFadeContext *s)
+{
+    XFadeSlideshow *show = s->show;
+    if (!show)
+        return;
+    for (int i = 0; i < show->nb_cuts && show->cuts; i++)
+        free_cut(&show->cuts[i]);
+    av_free(show->cuts);
+    av_free(show->offset_pts);
+    av_freep(&s->show);
+    s->k = NULL, s->e = NULL; // freed with cuts
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// live reconfiguration
+////////////////////////////////////////////////////////////////////////////////
+
+// options transition, easing and reverse take commands (sendcmd, zmq) while running:
+// vf_xfade:config_output() builds a new context that replaces the current one between transitions,
+// links and timing untouched, the current context kept if the new one fails
+
+// two inputs: reconfigure until the transition begins
+static int reconfig_transition(AVFilterLink *outlink)
+{
+    AVFilterContext *ctx = outlink->src;
+    XFadeContext *s = ctx->priv;
+
+    if (s->start_pts != AV_NOPTS_VALUE && s->pts >= s->start_pts) {
+        av_log(ctx, AV_LOG_WARNING, "transition already begun, command ignored\n");
+        return AVERROR(EBUSY);
+    }
+    XFadeCut old = { .k = s->k, .e = s->e, .transitionf = s->transitionf, .transition = s->transition, .reverse = s->reverse };
+    const int64_t start_pts = s->start_pts, inputs_offset_pts = s->inputs_offset_pts;
+    s->k = NULL, s->e = NULL;
+    int ret = config_output(outlink);
+    s->start_pts = start_pts, s->inputs_offset_pts = inputs_offset_pts;
+    if (ret < 0) { // restore
+        xe_data_free(s->k);
+        free_exprs(&s->e);
+        s->k = old.k, s->e = old.e;
+        s->transitionf = old.transitionf, s->transition = old.transition, s->reverse = old.reverse;
+        return ret;
+    }
+    xe_data_free(old.k);
+    free_exprs(&old.e);
+    return 0;
+}
+
+// slideshow: reconfigure all cuts not yet begun, or none
+static int reconfig_slideshow(AVFilterLink *outlink)
+{
+    AVFilterContext *ctx = outlink->src;
+    XFadeContext *s = ctx->priv;
+    XFadeSlideshow *show = s->show;
+    const int first = show->cut + (show->origin_pts != AV_NOPTS_VALUE && s->pts >= s->start_pts);
+    XFadeCut *cuts;
+    int ret = 0, i;
+
+    if (first >= show->nb_cuts) {
+        av_log(ctx, AV_LOG_WARNING, "final cut already begun, command ignored\n");
+        return AVERROR(EBUSY);
+    }
+    if (!(cuts = av_memdup(show->cuts, show->nb_cuts * sizeof(*cuts))))
+        return AVERROR(ENOMEM);
+    for (i = first; i < show->nb_cuts && ret >= 0; i++)
+        ret = config_cut(outlink, &cuts[i], i);
+    s->k = NULL, s->e = NULL; // held by cuts
+    XFadeCut *discard = ret < 0 ? cuts : show->cuts; // new cuts on failure, else old
+    for (int j = first; j < i; j++)
+        free_cut(&discard[j]);
+    if (ret >= 0)
+        FFSWAP(XFadeCut *, cuts, show->cuts);
+    av_free(cuts);
+    slideshow_cut(s, show->cut); // current cut, restored or reconfigured
+    return ret;
+}
+
+// whether pixel format f is in list l
+static bool format_listed(const enum AVPixelFormat *l, enum AVPixelFormat f)
+{
+    for (; *l != AV_PIX_FMT_NONE; l++)
+        if (*l == f)
+            return true;
+    return false;
+}
+
+// whether the negotiated format suits the transitions now set, cf. vf_xfade:query_formats()
+static bool format_supported(const XFadeContext *s, enum AVPixelFormat f)
+{
+    return format_listed(pix_fmts, f)
+        || (!xe_full_chroma(s) && (format_listed(subsampled_pix_fmts, f) || format_listed(float_pix_fmts, f)))
+        || (!xe_xfade_transition(s) && format_listed(packed_pix_fmts, f));
+}
+
+// vf_xfade:process_command()
+static int xe_process_command(AVFilterContext *ctx, const char *cmd, const char *args, char *res, int res_len, int flags)
+{
+    XFadeContext *s = ctx->priv;
+    uint8_t *old = NULL;
+    int ret;
+
+    if (av_opt_get(s, cmd, AV_OPT_ALLOW_NULL, &old) < 0)
+        return AVERROR(ENOSYS);
+    if ((ret = ff_filter_process_command(ctx, cmd, args, res, res_len, flags)) >= 0) {
+        AVFilterLink *outlink = ctx->outputs[0];
+        if (!format_supported(s, outlink->format))
+            ret = xe_error(ctx, "%s unsupported for negotiated pixel format %s\n", cmd, av_get_pix_fmt_name(outlink->format));
+        else
+            ret = s->show ? reconfig_slideshow(outlink) : reconfig_transition(outlink);
+        if (ret < 0)
+            av_opt_set(s, cmd, (const char *)old, 0); // option value of the running context
+        else
+            xe_debug(ctx, "process_command %s=%s\n", cmd, args);
+    }
+    av_free(old);
+    return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// compiled custom expressions
+////////////////////////////////////////////////////////////////////////////////
+
+// transition=custom expressions are parsed again into a tree that mirrors libavutil/eval.c,
+// constant folded and lowered to flat register code: subexpressions invariant along a row
+// (no X, A, B, ld() or st()) run once per row, the rest once per pixel, without recursion;
+// expressions using functions not compiled (taylor, root, gcd, print, random, randomi, time)
+// or whose compiled results differ from av_expr_eval() on a noise probe keep av_expr_eval()
+
+#define XE_VARS 10 // st()/ld() variables, cf. libavutil/eval.c
+
+enum XEType { // node and op types, cf. libavutil/eval.c
+    XE_VALUE, XE_CONST, XE_FUNC0, XE_FUNC1, XE_FUNC2, XE_SQUISH, XE_GAUSS, XE_LD, XE_ISNAN, XE_ISINF,
+    XE_FLOOR, XE_CEIL, XE_TRUNC, XE_ROUND, XE_SGN, XE_SQRT, XE_NOT, XE_IF, XE_IFNOT, XE_CLIP, XE_BETWEEN, XE_LERP,
+    XE_MOD, XE_MAX, XE_MIN, XE_EQ, XE_GT, XE_GTE, XE_LT, XE_LTE, XE_POW, XE_MUL, XE_DIV, XE_ADD, XE_LAST, XE_ST,
+    XE_HYPOT, XE_ATAN2, XE_BITAND, XE_BITOR, XE_WHILE,
+    XE_MULK, XE_MOV, XE_JZ, XE_JNZ, XE_JMP // ops only
+};
+
+typedef struct XENode { // parse tree node
+    int type;
+    double value; // constant, else result multiplier (sign)
+    int index; // variable, func1 or func2 index
+    double (*func0)(double);
+    struct XENode *param[3];
+    int reg; // result register, -1 until emitted
+    bool uniform; // invariant along a row
+    bool effect; // stores with st()
+} XENode;
+
+typedef struct XEOp { // register op, jumps to c
+    int op, d, a, b, c;
+    double k; // multiplier
+    double (*func0)(double);
+    double (*func1)(void *, double);
+    double (*func2)(void *, double, double);
+} XEOp;
+
+typedef struct XEProgram {
+    struct XECode { XEOp *ops; int nb; } row, pixel; // per row, per pixel
+    int nb_regs, result;
+    double *regs; // per slice job: registers, then st()/ld() variables
+} XEProgram;
+
+typedef struct XEParser {
+    const char *s;
+    XENode *nodes;
+    int nb_nodes, depth;
+    const char *const *func1_names, *const *func2_names;
+} XEParser;
+
+// cf. libavutil/eval.c strmatch()
+static bool xe_strmatch(const char *s, const char *prefix)
+{
+    const size_t n = strlen(prefix);
+    return !strncmp(s, prefix, n) && !(av_isdigit(s[n]) || av_isalpha(s[n]) || s[n] == '_');
+}
+
+static XENode *xe_node(XEParser *p, int type, double value, XENode *p0, XENode *p1)
+{
+    XENode *n = &p->nodes[p->nb_nodes++];
+    *n = (XENode){ .type = type, .value = value, .param = { p0, p1 }, .reg = -1 };
+    return n;
+}
+
+static XENode *xe_parse_expr(XEParser *p);
+
+static XENode *xe_parse_primary(XEParser *p)
+{
+    static const struct { const char *name; double value; double (*func0)(double); } constants[] = {
+        { "E", M_E }, { "PI", M_PI }, { "PHI", M_PHI }, { "QP2LAMBDA", 118 }
+    }, functions[] = {
+        { "sinh", 0, sinh }, { "cosh", 0, cosh }, { "tanh", 0, tanh }, { "sin", 0, sin }, { "cos", 0, cos },
+        { "tan", 0, tan }, { "atan", 0, atan }, { "asin", 0, asin }, { "acos", 0, acos }, { "exp", 0, exp },
+        { "log", 0, log }, { "abs", 0, fabs }
+    };
+    static const struct { const char *name; int type; } types[] = {
+        { "squish", XE_SQUISH }, { "gauss", XE_GAUSS }, { "mod", XE_MOD }, { "max", XE_MAX }, { "min", XE_MIN },
+        { "eq", XE_EQ }, { "gte", XE_GTE }, { "gt", XE_GT }, { "lte", XE_LTE }, { "lt", XE_LT }, { "ld", XE_LD },
+        { "isnan", XE_ISNAN }, { "isinf", XE_ISINF }, { "st", XE_ST }, { "floor", XE_FLOOR }, { "ceil", XE_CEIL },
+        { "trunc", XE_TRUNC }, { "round", XE_ROUND }, { "sqrt", XE_SQRT }, { "not", XE_NOT }, { "pow", XE_POW },
+        { "hypot", XE_HYPOT }, { "if", XE_IF }, { "ifnot", XE_IFNOT }, { "bitand", XE_BITAND }, { "bitor", XE_BITOR },
+        { "between", XE_BETWEEN }, { "clip", XE_CLIP }, { "atan2", XE_ATAN2 }, { "lerp", XE_LERP }, { "sgn", XE_SGN }, { "while", XE_WHILE }
+    };
+    XENode *n = xe_node(p, XE_VALUE, 0, NULL, NULL);
+    const char *name = p->s;
+    char *next;
+
+    n->value = av_strtod(p->s, &next);
+    if (next != p->s) { // number
+        p->s = next;
+        return n;
+    }
+    n->value = 1;
+    for (int i = 0; var_names[i]; i++)
+        if (xe_strmatch(p->s, var_names[i])) {
+            p->s += strlen(var_names[i]);
+            n->type = XE_CONST, n->index = i;
+            return n;
+        }
+    for (int i = 0; i < FF_ARRAY_ELEMS(constants); i++)
+        if (xe_strmatch(p->s, constants[i].name)) {
+            p->s += strlen(constants[i].name);
+            n->value = constants[i].value;
+            return n;
+        }
+
+    if (!(p->s = strchr(p->s, '(')))
+        return NULL;
+    p->s++;
+    if (*name == '(') { // parenthesised
+        n = xe_parse_expr(p);
+        if (!n || *p->s != ')')
+            return NULL;
+        p->s++;
+        return n;
+    }
+    for (int i = 0; i < 3 && (!i || *p->s == ','); i++) {
+        p->s += !!i;
+        if (!(n->param[i] = xe_parse_expr(p)))
+            return NULL;
+    }
+    if (*p->s != ')')
+        return NULL;
+    p->s++;
+
+    n->type = -1;
+    for (int i = 0; i < FF_ARRAY_ELEMS(functions) && n->type < 0; i++)
+        if (xe_strmatch(name, functions[i].name))
+            n->type = XE_FUNC0, n->func0 = functions[i].func0;
+    for (int i = 0; i < FF_ARRAY_ELEMS(types) && n->type < 0; i++)
+        if (xe_strmatch(name, types[i].name))
+            n->type = types[i].type;
+    for (int i = 0; p->func1_names[i] && n->type < 0; i++)
+        if (xe_strmatch(name, p->func1_names[i]))
+            n->type = XE_FUNC1, n->index = i;
+    for (int i = 0; p->func2_names[i] && n->type < 0; i++)
+        if (xe_strmatch(name, p->func2_names[i]))
+            n->type = XE_FUNC2, n->index = i;
+    if (n->type < 0)
+        return NULL; // not compiled
+
+    const int nb = !!n->param[0] + !!n->param[1] + !!n->param[2]; // arity, cf. libavutil/eval.c verify_expr()
+    switch (n->type) {
+    case XE_FUNC0: case XE_FUNC1: case XE_SQUISH: case XE_GAUSS: case XE_LD: case XE_ISNAN: case XE_ISINF: case XE_FLOOR:
+    case XE_CEIL: case XE_TRUNC: case XE_ROUND: case XE_SGN: case XE_SQRT: case XE_NOT:
+        return nb == 1 ? n : NULL;
+    case XE_IF: case XE_IFNOT:
+        return nb >= 2 ? n : NULL;
+    case XE_CLIP: case XE_BETWEEN: case XE_LERP:
+        return nb == 3 ? n : NULL;
+    default:
+        return nb == 2 ? n : NULL;
+    }
+}
+
+// signed operand, cf. libavutil/eval.c parse_dB(), parse_pow()
+static XENode *xe_parse_signed(XEParser *p, int *sign)
+{
+    char *next;
+    if (*p->s == '-' && (strtod(p->s, &next), next != p->s) && next[0] == 'd' && next[1] == 'B') {
+        *sign = 0; // -3dB is not -(3dB)
+        return xe_parse_primary(p);
+    }
+    *sign = (*p->s == '+') - (*p->s == '-');
+    p->s += *sign & 1;
+    return xe_parse_primary(p);
+}
+
+static XENode *xe_parse_factor(XEParser *p)
+{
+    int sign, sign2;
+    XENode *n = xe_parse_signed(p, &sign), *e;
+    while (n && *p->s == '^') {
+        p->s++;
+        if (!(e = xe_parse_signed(p, &sign2)))
+            return NULL;
+        e->value *= sign2 | 1;
+        n = xe_node(p, XE_POW, 1, n, e);
+    }
+    if (n)
+        n->value *= sign | 1;
+    return n;
+}
+
+static XENode *xe_parse_term(XEParser *p)
+{
+    XENode *n = xe_parse_factor(p), *e;
+    while (n && (*p->s == '*' || *p->s == '/')) {
+        const int c = *p->s++;
+        if (!(e = xe_parse_factor(p)))
+            return NULL;
+        n = xe_node(p, c == '*' ? XE_MUL : XE_DIV, 1, n, e);
+    }
+    return n;
+}
+
+static XENode *xe_parse_subexpr(XEParser *p)
+{
+    XENode *n = xe_parse_term(p), *e;
+    while (n && (*p->s == '+' || *p->s == '-')) { // sign taken by the term
+        if (!(e = xe_parse_term(p)))
+            return NULL;
+        n = xe_node(p, XE_ADD, 1, n, e);
+    }
+    return n;
+}
+
+static XENode *xe_parse_expr(XEParser *p)
+{
+    XENode *n, *e;
+    if (p->depth++ > 100) // cf. libavutil/eval.c stack_index
+        return NULL;
+    n = xe_parse_subexpr(p);
+    while (n && *p->s == ';') {
+        p->s++;
+        if (!(e = xe_parse_subexpr(p)))
+            return NULL;
+        n = xe_node(p, XE_LAST, 1, n, e);
+    }
+    p->depth--;
+    return n;
+}
+
+// run code on registers r with variables v
+static void xe_run(const struct XECode *c, double *r, double *v, void *opaque)
+{
+    for (const XEOp *o = c->ops, *end = c->ops + c->nb; o < end; o++) {
+        double x = r[o->a], y = r[o->b];
+        switch (o->op) {
+        case XE_VALUE:  r[o->d] = o->k; break;
+        case XE_MOV:    r[o->d] = x; break;
+        case XE_MULK:   r[o->d] = o->k * x; break;
+        case XE_FUNC0:  r[o->d] = o->func0(x); break;
+        case XE_FUNC1:  r[o->d] = o->func1(opaque, x); break;
+        case XE_FUNC2:  r[o->d] = o->func2(opaque, x, y); break;
+        case XE_SQUISH: r[o->d] = 1 / (1 + exp(4 * x)); break;
+        case XE_GAUSS:  r[o->d] = exp(-x * x / 2) / sqrt(2 * M_PI); break;
+        case XE_LD:     r[o->d] = v[av_clip(x, 0, XE_VARS - 1)]; break;
+        case XE_ISNAN:  r[o->d] = !!isnan(x); break;
+        case XE_ISINF:  r[o->d] = !!isinf(x); break;
+        case XE_FLOOR:  r[o->d] = floor(x); break;
+        case XE_CEIL:   r[o->d] = ceil(x); break;
+        case XE_TRUNC:  r[o->d] = trunc(x); break;
+        case XE_ROUND:  r[o->d] = round(x); break;
+        case XE_SGN:    r[o->d] = FFDIFFSIGN(x, 0); break;
+        case XE_SQRT:   r[o->d] = sqrt(x); break;
+        case XE_NOT:    r[o->d] = x == 0; break;
+        case XE_CLIP: {
+            const double min = y, max = r[o->c];
+            r[o->d] = isnan(min) || isnan(max) || isnan(x) || min > max ? NAN : o->k * av_clipd(x, min, max);
+            break;
+        }
+        case XE_LERP:   r[o->d] = x + (y - x) * r[o->c]; break;
+        case XE_MOD:    r[o->d] = x - floor(y ? x / y : x * INFINITY) * y; break;
+        case XE_MAX:    r[o->d] = x > y ? x : y; break;
+        case XE_MIN:    r[o->d] = x < y ? x : y; break;
+        case XE_EQ:     r[o->d] = x == y ? 1.0 : 0.0; break;
+        case XE_GT:     r[o->d] = x >  y ? 1.0 : 0.0; break;
+        case XE_GTE:    r[o->d] = x >= y ? 1.0 : 0.0; break;
+        case XE_LT:     r[o->d] = x <  y ? 1.0 : 0.0; break;
+        case XE_LTE:    r[o->d] = x <= y ? 1.0 : 0.0; break;
+        case XE_POW:    r[o->d] = pow(x, y); break;
+        case XE_MUL:    r[o->d] = x * y; break;
+        case XE_DIV:    r[o->d] = y ? x / y : x * INFINITY; break;
+        case XE_ADD:    r[o->d] = x + y; break;
+        case XE_LAST:   r[o->d] = y; break;
+        case XE_ST:     r[o->d] = v[av_clip(x, 0, XE_VARS - 1)] = y; break;
+        case XE_HYPOT:  r[o->d] = hypot(x, y); break;
+        case XE_ATAN2:  r[o->d] = atan2(x, y); break;
+        case XE_BITAND: r[o->d] = isnan(x) || isnan(y) ? NAN : (double)((long int)x & (long int)y); break;
+        case XE_BITOR:  r[o->d] = isnan(x) || isnan(y) ? NAN : (double)((long int)x | (long int)y); break;
+        case XE_JZ:     if (!x) o = c->ops + o->c - 1; break;
+        case XE_JNZ:    if (x) o = c->ops + o->c - 1; break;
+        case XE_JMP:    o = c->ops + o->c - 1; break;
+        }
+    }
+}
+
+typedef struct XECompiler {
+    struct XECode code[2]; // row, pixel
+    double *regs; // initial register values
+    int nb_regs;
+    double (*const *func1)(void *, double);
+    double (*const *func2)(void *, double, double);
+} XECompiler;
+
+static int xe_reg(XECompiler *c, double value)
+{
+    c->regs[c->nb_regs] = value;
+    return c->nb_regs++;
+}
+
+static int xe_op(XECompiler *c, bool row, int op, int d, int a, int b, int cc, double k)
+{
+    struct XECode *code = &c->code[!row];
+    code->ops[code->nb] = (XEOp){ .op = op, .d = d, .a = a, .b = b, .c = cc, .k = k };
+    return code->nb++;
+}
+
+// emit node n to the row or pixel code, returns its register
+static int xe_emit(XECompiler *c, XENode *n, bool row)
+{
+    if (n->reg >= 0)
+        return n->reg;
+    if (n->uniform && !row && n->type != XE_VALUE)
+        return xe_emit(c, n, true); // hoisted
+    struct XECode *code = &c->code[!row];
+    const int t = n->type;
+    int a = 0, b = 0, r = 0, d, j, jmp;
+
+    switch (t) {
+    case XE_VALUE:
+        return n->reg = xe_reg(c, n->value);
+    case XE_CONST:
+        if (n->value == 1)
+            return n->reg = n->index; // variable register
+        xe_op(c, row, XE_MULK, d = xe_reg(c, 0), n->index, 0, 0, n->value);
+        return n->reg = d;
+    case XE_IF: case XE_IFNOT:
+        j = xe_op(c, row, t == XE_IF ? XE_JZ : XE_JNZ, 0, xe_emit(c, n->param[0], row), 0, 0, 0);
+        d = xe_reg(c, 0);
+        xe_op(c, row, XE_MOV, d, xe_emit(c, n->param[1], row), 0, 0, 0);
+        jmp = xe_op(c, row, XE_JMP, 0, 0, 0, 0, 0);
+        code->ops[j].c = code->nb;
+        if (n->param[2])
+            xe_op(c, row, XE_MOV, d, xe_emit(c, n->param[2], row), 0, 0, 0);
+        else
+            xe_op(c, row, XE_VALUE, d, 0, 0, 0, 0);
+        code->ops[jmp].c = code->nb;
+        break;
+    case XE_WHILE: // NAN unless run, cf. libavutil/eval.c
+        xe_op(c, row, XE_VALUE, d = xe_reg(c, 0), 0, 0, 0, NAN);
+        jmp = code->nb;
+        j = xe_op(c, row, XE_JZ, 0, xe_emit(c, n->param[0], row), 0, 0, 0);
+        xe_op(c, row, XE_MOV, d, xe_emit(c, n->param[1], row), 0, 0, 0);
+        xe_op(c, row, XE_JMP, 0, 0, 0, jmp, 0);
+        code->ops[j].c = code->nb;
+        return n->reg = d; // no multiplier
+    case XE_BETWEEN: // short-circuit upper bound
+        a = xe_emit(c, n->param[0], row);
+        xe_op(c, row, XE_GTE, d = xe_reg(c, 0), a, xe_emit(c, n->param[1], row), 0, 0);
+        j = xe_op(c, row, XE_JZ, 0, d, 0, 0, 0);
+        xe_op(c, row, XE_LTE, d, a, xe_emit(c, n->param[2], row), 0, 0);
+        code->ops[j].c = code->nb;
+        break;
+    default:
+        for (int i = 0; i < 3; i++) { // in evaluation order
+            const int p = n->param[i] ? xe_emit(c, n->param[i], row) : 0;
+            if (i == 0) a = p; else if (i == 1) b = p; else r = p;
+        }
+        j = xe_op(c, row, t, d = xe_reg(c, 0), a, b, r, n->value);
+        code->ops[j].func0 = n->func0;
+        code->ops[j].func1 = t == XE_FUNC1 ? c->func1[n->index] : NULL;
+        code->ops[j].func2 = t == XE_FUNC2 ? c->func2[n->index] : NULL;
+        if (t == XE_CLIP || t == XE_LERP || t == XE_SQUISH || t == XE_GAUSS)
+            return n->reg = d; // multiplier applied by op or not at all, cf. libavutil/eval.c
+    }
+    if (n->value != 1)
+        xe_op(c, row, XE_MULK, d, d, 0, 0, n->value);
+    return n->reg = d;
+}
+
+// fold constant subtrees, mark row invariants and stores, false if not compiled
+static bool xe_fold(XENode *n)
+{
+    bool constant = n->type != XE_CONST && n->type != XE_LD && n->type != XE_ST && n->type != XE_FUNC1 && n->type != XE_FUNC2
+                 && n->type != XE_WHILE;
+    n->uniform = n->type != XE_LD && n->type != XE_ST
+              && !(n->type == XE_CONST && (n->index == VAR_X || n->index == VAR_A || n->index == VAR_B));
+    n->effect = n->type == XE_ST;
+    for (int i = 0; i < 3 && n->param[i]; i++) {
+        XENode *p = n->param[i];
+        if (!xe_fold(p))
+            return false;
+        constant &= p->type == XE_VALUE;
+        n->uniform &= p->uniform;
+        n->effect |= p->effect;
+    }
+    if ((n->type == XE_CLIP && n->param[0]->effect) // evaluated twice by libavutil/eval.c
+        || (n->type == XE_FUNC2 && (n->param[0]->effect || n->param[1]->effect))) // unspecified argument order
+        return false;
+    if (constant && n->type != XE_VALUE) { // run its code
+        XEOp ops[8];
+        double regs[8];
+        XECompiler c = { .code = { { ops }, { ops } }, .regs = regs };
+        const int r = xe_emit(&c, n, true);
+        xe_run(&c.code[0], regs, NULL, NULL);
+        *n = (XENode){ .type = XE_VALUE, .value = regs[r], .reg = -1, .uniform = true };
+    }
+    return true;
+}
+
+// fill frame with pseudo-random component values
+static void noise_frame(const XFadeContext *s, AVFrame *f, uint32_t *seed)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(f->format);
+    for (int p = 0; p < s->nb_planes; p++) {
+        const int bytes = av_image_get_linesize(f->format, f->width, p);
+        const int height = p == 1 || p == 2 ? AV_CEIL_RSHIFT(f->height, desc->log2_chroma_h) : f->height;
+        for (int y = 0; y < height; y++) {
+            uint8_t *d = f->data[p] + y * f->linesize[p];
+            if (s->k->is_float)
+                for (int x = 0; x < bytes / 4; x++)
+                    *seed = *seed * 1664525 + 1013904223, ((float *)d)[x] = (*seed >> 8) / 16777216.f;
+            else
+                for (int x = 0; x < bytes; x++)
+                    *seed = *seed * 1664525 + 1013904223, d[x] = *seed >> 24;
+        }
+    }
+}
+
+// evaluate compiled and interpreted expressions on noise, true if identical
+static bool xe_probe_expr(AVFilterContext *ctx, XEProgram *x, AVExpr *e)
+{
+    XFadeContext *s = ctx->priv;
+    AVFilterLink *outlink = ctx->outputs[0];
+    AVFrame *f[2] = { 0 };
+    uint32_t seed = 1;
+    bool same = false;
+    for (int i = 0; i < 2; i++)
+        if (!(f[i] = ff_get_video_buffer(outlink, outlink->w, outlink->h)))
+            goto end;
+    same = true;
+    noise_frame(s, f[0], &seed);
+    noise_frame(s, f[1], &seed);
+    ExprData d = { .s = s, .xf = { f[0], f[1] } };
+    double values[VAR_VARS_NB], *r = x->regs, *v = r + x->nb_regs;
+    const int w = outlink->w, h = outlink->h;
+    for (int i = 0; i <= 4 && same; i++) {
+        r[VAR_W] = values[VAR_W] = w;
+        r[VAR_H] = values[VAR_H] = h;
+        r[VAR_PROGRESS] = values[VAR_PROGRESS] = i / 4.;
+        r[VAR_UNEASED] = values[VAR_UNEASED] = 1 - i / 4.;
+        r[VAR_EASED] = values[VAR_EASED] = (i - 1) / 2.; // overshoots
+        for (int p = 0; p < s->nb_planes && same; p++) {
+            r[VAR_PLANE] = values[VAR_PLANE] = p;
+            for (int gy = 0; gy < 8 && same; gy++) {
+                const int y = gy * (h - 1) / 7;
+                r[VAR_Y] = values[VAR_Y] = y;
+                xe_run(&x->row, r, v, &d);
+                for (int gx = 0; gx < 8 && same; gx++) {
+                    const int X = gx * (w - 1) / 7;
+                    const uint8_t *a = f[0]->data[p] + y * f[0]->linesize[p], *b = f[1]->data[p] + y * f[1]->linesize[p];
+                    r[VAR_X] = values[VAR_X] = X;
+                    r[VAR_A] = values[VAR_A] = s->depth > 8 ? ((const uint16_t *)a)[X] : a[X];
+                    r[VAR_B] = values[VAR_B] = s->depth > 8 ? ((const uint16_t *)b)[X] : b[X];
+                    xe_run(&x->pixel, r, v, &d);
+                    const double u = av_expr_eval(e, values, &d), c = r[x->result];
+                    same = u == c || (isnan(u) && isnan(c));
+                }
+            }
+        }
+    }
+end:
+    av_frame_free(&f[0]);
+    av_frame_free(&f[1]);
+    return same;
+}
+
+#define XE_CUSTOM_TRANSITION(name, type, div)                                                      \
+static void xe_custom##name##_transition(AVFilterContext *ctx, const AVFrame *a, const AVFrame *b, \
+                                         AVFrame *out, float progress,                             \
+                                         int slice_start, int slice_end, int jobnr)                \
+{                                                                                                  \
+    const XFadeContext *s = ctx->priv;                                                             \
+    const XEProgram *x = s->k->program;                                                            \
+    double *r = x->regs + jobnr * (x->nb_regs + XE_VARS), *v = r + x->nb_regs;                     \
+    ExprData d = { .s = s, .xf = { a, b } };                                                       \
+    r[VAR_W] = out->width;                                                                         \
+    r[VAR_H] = out->height;                                                                        \
+    r[VAR_PROGRESS] = progress;                                                                    \
+    r[VAR_UNEASED] = s->progress[0];                                                               \
+    r[VAR_EASED] = s->progress[1];                                                                 \
+    for (int p = 0; p < s->nb_planes; p++) {                                                       \
+        const type *xf0 = (const type *)(a->data[p] + slice_start * a->linesize[p]);               \
+        const type *xf1 = (const type *)(b->data[p] + slice_start * b->linesize[p]);               \
+        type *dst = (type *)(out->data[p] + slice_start * out->linesize[p]);                       \
+        r[VAR_PLANE] = p;                                                                          \
+        for (int y = slice_start; y < slice_end; y++) {                                            \
+            r[VAR_Y] = y;                                                                          \
+            xe_run(&x->row, r, v, &d);                                                             \
+            for (int i = 0; i < out->width; i++) {                                                 \
+                r[VAR_X] = i;                                                                      \
+                r[VAR_A] = xf0[i];                                                                 \
+                r[VAR_B] = xf1[i];                                                                 \
+                xe_run(&x->pixel, r, v, &d);                                                       \
+                dst[i] = r[x->result];                                                             \
+            }                                                                                      \
+            dst += out->linesize[p] / div;                                                         \
+            xf0 += a->linesize[p] / div;                                                           \
+            xf1 += b->linesize[p] / div;                                                           \
+        }                                                                                          \
+    }                                                                                              \
+}
+
+XE_CUSTOM_TRANSITION(8, uint8_t, 1)
+XE_CUSTOM_TRANSITION(16, uint16_t, 2)
+
+// option mask: the expression gives the weight of the second input (b) or first (a), evaluated once per pixel
+// with PLANE 0 and A, B of plane 0, then all planes mix as B * w + A * (1 - w) or A * w + B * (1 - w),
+// as the full expression mixes them, so xfade-easing.sh -M output matches it exactly
+#define XE_MASK_TRANSITION(name, type)                                                             \
+static void xe_mask##name##_transition(AVFilterContext *ctx, const AVFrame *a, const AVFrame *b,   \
+                                       AVFrame *out, float progress,                               \
+                                       int slice_start, int slice_end, int jobnr)                  \
+{                                                                                                  \
+    const XFadeContext *s = ctx->priv;                                                             \
+    const XEProgram *x = s->k->program; /* else av_expr_eval() */                                  \
+    double values[VAR_VARS_NB], *r = x ? x->regs + jobnr * (x->nb_regs + XE_VARS) : values;        \
+    double *v = x ? r + x->nb_regs : NULL;                                                         \
+    ExprData d = { .s = s, .xf = { a, b } };                                                       \
+    const type *xf0[4], *xf1[4];                                                                   \
+    type *dst[4];                                                                                  \
+    r[VAR_W] = out->width;                                                                         \
+    r[VAR_H] = out->height;                                                                        \
+    r[VAR_PROGRESS] = progress;                                                                    \
+    r[VAR_UNEASED] = s->progress[0];                                                               \
+    r[VAR_EASED] = s->progress[1];                                                                 \
+    r[VAR_PLANE] = 0;                                                                              \
+    for (int y = slice_start; y < slice_end; y++) {                                                \
+        for (int p = 0; p < s->nb_planes; p++) {                                                   \
+            xf0[p] = (const type *)(a->data[p] + y * a->linesize[p]);                              \
+            xf1[p] = (const type *)(b->data[p] + y * b->linesize[p]);                              \
+            dst[p] = (type *)(out->data[p] + y * out->linesize[p]);                                \
+        }                                                                                          \
+        r[VAR_Y] = y;                                                                              \
+        if (x)                                                                                     \
+            xe_run(&x->row, r, v, &d);                                                             \
+        for (int i = 0; i < out->width; i++) {                                                     \
+            r[VAR_X] = i;                                                                          \
+            r[VAR_A] = xf0[0][i];                                                                  \
+            r[VAR_B] = xf1[0][i];                                                                  \
+            double w;                                                                              \
+            if (x) {                                                                               \
+                xe_run(&x->pixel, r, v, &d);                                                       \
+                w = r[x->result];                                                                  \
+            } else                                                                                 \
+                w = av_expr_eval(s->e[jobnr], r, &d);                                              \
+            if (s->mask == MASK_A)                                                                 \
+                for (int p = 0; p < s->nb_planes; p++)                                             \
+                    dst[p][i] = (double)xf0[p][i] * w + (double)xf1[p][i] * (1 - w);               \
+            else                                                                                   \
+                for (int p = 0; p < s->nb_planes; p++)                                             \
+                    dst[p][i] = (double)xf1[p][i] * w + (double)xf0[p][i] * (1 - w);               \
+        }                                                                                          \
+    }                                                                                              \
+}
+
+XE_MASK_TRANSITION(8, uint8_t)
+XE_MASK_TRANSITION(16, uint16_t)
+
+static void xe_program_free(XEProgram **x)
+{
+    if (!*x)
+        return;
+    av_free((*x)->row.ops);
+    av_free((*x)->pixel.ops);
+    av_free((*x)->regs);
+    av_freep(x);
+}
+
+// compile the custom expression for vf_xfade:config_output(), 1 if compiled, 0 to evaluate with av_expr_eval()
+static int xe_compile_expr(AVFilterContext *ctx, const char *expr,
+                           const char *const *func1_names, double (*const *func1)(void *, double),
+                           const char *const *func2_names, double (*const *func2)(void *, double, double))
+{
+    XFadeContext *s = ctx->priv;
+    XFadeEasingContext *k = s->k;
+    const int nb_jobs = ff_filter_get_nb_threads(ctx);
+    XEParser p = { .func1_names = func1_names, .func2_names = func2_names };
+    XECompiler c = { .func1 = func1, .func2 = func2 };
+    XEProgram *x = NULL;
+    AVExpr *e = NULL;
+    char *w = av_malloc(strlen(expr) + 1), *t = w;
+    int ret = AVERROR(ENOMEM);
+
+    if (!w)
+        return ret;
+    for (const char *i = expr; *i; i++) // cf. libavutil/eval.c av_expr_parse()
+        if (!av_isspace(*i))
+            *t++ = *i;
+    *t = '\0';
+    const int max = t - w + 1; // nodes, each taking at least one character
+    if (!(p.nodes = av_malloc_array(max, sizeof(*p.nodes)))
+        || !(c.regs = av_malloc_array(max + VAR_VARS_NB, sizeof(*c.regs)))
+        || !(c.code[0].ops = av_malloc_array(max * 6, sizeof(XEOp)))
+        || !(c.code[1].ops = av_malloc_array(max * 6, sizeof(XEOp)))
+        || !(x = av_mallocz(sizeof(*x))))
+        goto end;
+    ret = 0;
+    p.s = w;
+    XENode *n = xe_parse_expr(&p);
+    if (!n || *p.s || !xe_fold(n)) {
+        xe_debug(ctx, "custom expression not compiled\n");
+        goto end;
+    }
+
+    c.nb_regs = VAR_VARS_NB; // input variables, then constants and results
+    x->result = xe_emit(&c, n, false);
+    x->row = c.code[0], x->pixel = c.code[1];
+    c.code[0].ops = c.code[1].ops = NULL; // held by program
+    x->nb_regs = c.nb_regs;
+    if (!(x->regs = av_calloc(nb_jobs, (x->nb_regs + XE_VARS) * sizeof(*x->regs)))) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+    for (int i = 0; i < nb_jobs; i++)
+        memcpy(x->regs + i * (x->nb_regs + XE_VARS), c.regs, x->nb_regs * sizeof(*c.regs));
+
+    if (av_expr_parse(&e, expr, var_names, func1_names, func1, func2_names, func2, 0, ctx) < 0
+        || !xe_probe_expr(ctx, x, e)) {
+        av_log(ctx, AV_LOG_VERBOSE, "compiled custom expression differs from av_expr_eval(), not used\n");
+        goto end;
+    }
+    memset(x->regs + x->nb_regs, 0, XE_VARS * sizeof(*x->regs)); // variables as after parsing
+    xe_debug(ctx, "custom expression compiled: %d nodes, %d row ops, %d pixel ops, %d registers\n",
+             p.nb_nodes, x->row.nb, x->pixel.nb, x->nb_regs);
+    k->program = x, x = NULL;
+    s->transitionf = s->depth <= 8 ? xe_custom8_transition : xe_custom16_transition;
+    ret = 1;
+end:
+    av_expr_free(e);
+    xe_program_free(&x);
+    av_free(c.code[0].ops);
+    av_free(c.code[1].ops);
+    av_free(c.regs);
+    av_free(p.nodes);
+    av_free(w);
+    return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// argument parsing
+////////////////////////////////////////////////////////////////////////////////
+
+// emit error message, reduces verbosity
+static int xe_error(void *avcl, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    av_vlog(avcl, AV_LOG_ERROR, fmt, args);
+    va_end(args);
+    return AVERROR(EINVAL);
+}
+
+// emit warning message
+static void xe_warning(void *avcl, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    av_vlog(avcl, AV_LOG_WARNING, fmt, args);
+    va_end(args);
+}
+
+// emit debug message
+static void xe_debug(void *avcl, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    av_log(avcl, AV_LOG_DEBUG, "xfade-easing: ");
+    av_vlog(avcl, AV_LOG_DEBUG, fmt, args);
+    va_end(args);
+}
+
+// remove extraneous spaces in place
+static void rmspace(char *s)
+{
+    char *d = s;
+    char c, l = 0;
+    while ((c = *s++)) {
+        // trim name part
+        if (c != '(') {
+            if (c != ' ')
+                l = c;
+            *d++ = c;
+            continue;
+        }
+        if (l)
+            while (d[-1] != l)
+                d--;
+        *d++ = l = c;
+        // trim args allowing single space between CSV tokens
+        bool b = 0, e;
+        while ((c = *s++)) {
+            if (c != ' ' || (b && l != ' ')) {
+                if ((e = (c == ',' || c == ')')))
+                    if (b && l == ' ')
+                        d--;
+                b = !e;
+                *d++ = l = c;
+            }
+        }
+        break;
+    }
+    *d = 0;
+}
+
+// like strtok_r but doesn't skip empty values between commas
+static char *csvtok(char *s, char **p)
+{
+    char *c = s ? s : (s = *p);
+    if (!*c)
+        return NULL;
+    while (*c) {
+        if (*c++ == ',') {
+            c[-1] = 0;
+            break;
+        }
+    }
+    *p = c;
+    return s;
+}
+
+// parse a number or colour
+static double argv(char *s, char **p)
+{
+    char *c;
+    double d = strtod(s, &c); // try number (inc. grey)
+    if (*s == '#' || !strncmp(s, "0x", 2) || isalpha(*s) || strchr(s, '@')) { // try colour
+        c = s;
+        uint8_t rgba[4];
+        if (!av_parse_color(rgba, s, -1, NULL)) { // (fails for 0X prefix)
+            uint32_t u = rgba[0] << 24 | rgba[1] << 16 | rgba[2] << 8 | rgba[3];
+            uint64_t l = u | 1ULL << 32; // colour flag bit 32 ensures value > 1
+            d = l;
+            c += strlen(s);
+        }
+    }
+    *p = c;
+    return d;
+}
+
+// standard/supplementary easing mode
+static int parse_standard_easing(AVFilterContext *ctx, char *args)
+{
+    XFadeContext *s = ctx->priv;
+    struct Standard *a = &s->k->eargs.e;
+    s->k->eargs.type = STANDARD;
+    char *p = strchr(s->easing_str, '-');
+    if (!p) a->mode = EASE_INOUT;
+    else if (!av_strcasecmp(p, "-in-out")) a->mode = EASE_INOUT;
+    else if (!av_strcasecmp(p, "-in")) a->mode = EASE_IN;
+    else if (!av_strcasecmp(p, "-out")) a->mode = EASE_OUT;
+    else return xe_error(ctx, "unknown easing function %s\n", s->easing_str);
+    if (args)
+        xe_warning(ctx, "ignoring extraneous easing arguments %s\n", args);
+    xe_debug(ctx, "easing = %s[%d]\n", s->easing_str, a->mode);
+    return 0;
+}
+
+// CSS linear()
+static int parse_linear_easing(AVFilterContext *ctx, char *args)
+{
+    if (!args)
+        return 0;
+    XFadeContext *s = ctx->priv;
+    struct Linear *a = &s->k->eargs.l;
+    s->k->eargs.type = LINEAR;
+    // parse
+    char *e, *c, *b, *t;
+    float d = -FLT_MAX; // ensure x increases
+    while ((e = csvtok(args, &c))) { // each arg
+        if (!*e)
+            return xe_error(ctx, "expected number in easing option\n");
+        e = av_strtok(e, " ", &b);
+        float x = NAN, y = strtof(e, &t);
+        if (t == e || *t != 0)
+            return xe_error(ctx, "bad number %s in easing option\n", e);
+        int i, n = 1;
+        vec2 q[2];
+        for (i = 0; i < 2; i++) {
+            if ((e = av_strtok(NULL, " ", &b))) { // have %
+                x = strtof(e, &t);
+                if (t == e || *t != '%')
+                    return xe_error(ctx, "bad number %s in easing option\n", e);
+                x = d = maxf(x * 0.01f, d);
+                if (i)
+                    n++;
+            }
+            q[i] = VEC2(x, y);
+        }
+        if (!(a->points = av_realloc_array(a->points, a->stops + n, sizeof(*a->points))))
+            return AVERROR(ENOMEM);
+        for (i = 0; i < n; i++)
+            a->points[a->stops++] = q[i];
+        args = NULL;
+    }
+    // interpolate x gaps
+    int n = a->stops;
+    if (n < 2)
+        return xe_error(ctx, "expected at least 2 easing arguments, got %d\n", n);
+    vec2 *p = a->points;
+    if (isnan(p[0].x))
+        p[0].x = 0;
+    if (isnan(p[n - 1].x))
+        p[n - 1].x = 1;
+    for (int i = 1, j = 0; i < n; i++) {
+        float x = p[i].x;
+        if (!isnan(x)) {
+            if (i - j > 1) {
+                d = (x - p[j].x) / (i - j);
+                for (j++; j < i; j++)
+                    p[j].x = p[j - 1].x + d;
+                p[j].x = x;
+            }
+            j = i;
+        }
+    }
+    xe_debug(ctx, "easing = %s[%d](", s->easing_str, n);
+    for (int i = 0; i < n; i++)
+        av_log(ctx, AV_LOG_DEBUG, "%s%g %g", i ? ", " : "", a->points[i].x, a->points[i].y);
+    av_log(ctx, AV_LOG_DEBUG, ")\n");
+    return 0;
+}
+
+// CSS cubic-bezier()
 static int parse_cubic_bezier_easing(AVFilterContext *ctx, char *args)
 {
     XFadeContext *s = ctx->priv;
@@ -2839,6 +5140,19 @@ static int parse_xtransition(AVFilterContext *ctx)
     else if (!av_strcasecmp(t, "test_texture")) k->xtransitionf = test_texture;
     else return xe_error(ctx, "unknown extended transition name %s\n", t);
 
+    // gather-heavy transitions, rendered in tiles by default
+    static vec4 (*const gathers[])(const XTransition *e) = {
+        gl_CrossZoom, // rays to centre
+        gl_Exponential_Swish, // zoomed blur
+        gl_kaleidoscope, // mirrored rotations
+        gl_LinearBlur, // blur along a line
+        gl_powerKaleido, // mirrored rotations
+        gl_Swirl, // rotation within radius
+    };
+    for (int i = 0; i < FF_ARRAY_ELEMS(gathers); i++)
+        if (k->xtransitionf == gathers[i])
+            k->gather = true;
+
     XTransitionArgs *a = &k->targs;
     if ((p = av_strtok(NULL, ")", &c))) { // has args
         while ((t = csvtok(p, &c))) { // next arg
@@ -2872,6 +5186,64 @@ static int parse_xtransition(AVFilterContext *ctx)
 // configuration
 ////////////////////////////////////////////////////////////////////////////////
 
+// option samples: log the easing curve as CSV rows "easing",progress,eased in transition direction,
+// unclipped so overshoots show, for plotting (each slideshow cut logs its own easing)
+static int xe_log_samples(AVFilterContext *ctx, const char *easing)
+{
+    const XFadeContext *s = ctx->priv;
+    const XFadeEasingContext *k = s->k;
+    const bool rev = s->reverse & REVERSE_EASING;
+    const int n = s->samples + 1;
+    float *y = av_malloc_array(n, sizeof(*y));
+    if (!y)
+        return AVERROR(ENOMEM);
+    for (int i = 0; i < n; i++)
+        y[i] = rev ? 1 - (float)i / s->samples : (float)i / s->samples;
+    xe_ease_array(k, y, y, n);
+    for (int i = 0; i < n; i++) {
+        const float x = (float)i / s->samples;
+        av_log(NULL, AV_LOG_INFO, "\"%s\",%g,%.6f\n", easing, x, !k->easingf ? x : rev ? 1 - y[i] : y[i]);
+    }
+    av_free(y);
+    return 0;
+}
+
+// precompute frame progress for each frame index of the transition at the output frame rate, eased as one array,
+// sparing easing solvers (CSS cubic-bezier) per frame; frames off the index grid compute their own
+static int xe_config_steps(AVFilterContext *ctx)
+{
+    XFadeContext *s = ctx->priv;
+    XFadeEasingContext *k = s->k;
+    AVFilterLink *l = ctx->outputs[0];
+#if LIBAVFILTER_VERSION_INT < AV_VERSION_INT(10, 4, 100)
+    const AVRational fr = l->frame_rate; // v6.x, v7.0
+#else
+    const AVRational fr = ff_filter_link(l)->frame_rate; // v7.1
+#endif
+    if (fr.num <= 0 || fr.den <= 0 || s->duration_pts <= 0)
+        return 0; // variable frame rate or no transition
+    k->frame_pts = av_div_q(av_inv_q(fr), l->time_base);
+    k->nb_steps = av_rescale_rnd(s->duration_pts, k->frame_pts.den, k->frame_pts.num, AV_ROUND_UP) + 1;
+    float *x = av_malloc_array(k->nb_steps, sizeof(*x));
+    if (!x || !(k->steps = av_malloc_array(k->nb_steps, sizeof(*k->steps)))) {
+        av_free(x);
+        return AVERROR(ENOMEM);
+    }
+    for (int i = 0; i < k->nb_steps; i++) {
+        struct XFadeStep *t = &k->steps[i];
+        t->pts = av_rescale_rnd(i, k->frame_pts.num, k->frame_pts.den, AV_ROUND_NEAR_INF);
+        t->progress = xe_step_progress(s, t->pts);
+        x[i] = 1 - t->progress; // as ease()
+    }
+    xe_ease_array(k, x, x, k->nb_steps);
+    for (int i = 0; i < k->nb_steps; i++) {
+        const struct XFadeStep *t = &k->steps[i];
+        k->steps[i] = xe_resolve_step(s, t->pts, t->progress, k->easingf ? 1 - x[i] : t->progress);
+    }
+    av_free(x);
+    return 0;
+}
+
 // install
 static int config_xfade_easing(AVFilterContext *ctx)
 {
@@ -2885,11 +5257,42 @@ static int config_xfade_easing(AVFilterContext *ctx)
     s->k = k;
     k->s = s;
 
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(ctx->outputs[0]->format);
+    k->n = desc->nb_components;
+    if (desc->comp[0].shift) { // MSB aligned (P010): process as 16 bit, cf. vf_xfade:config_output()
+        s->depth = desc->comp[0].depth + desc->comp[0].shift;
+        s->max_value = (1 << s->depth) - 1;
+        s->black[1] = s->black[2] = s->max_value / 2;
+        s->black[3] = s->white[0] = s->white[3] = s->max_value;
+        s->white[1] = s->white[2] = s->max_value / 2;
+    }
+    k->is_float = desc->flags & AV_PIX_FMT_FLAG_FLOAT;
+    k->is_16 = s->depth > 8 && !k->is_float;
+    comp_layout(desc, k->comp);
+#if LIBAVFILTER_VERSION_INT < AV_VERSION_INT(10, 4, 100)
+    k->yuv = &BT601; // v6.x, v7.0
+#else
+    k->yuv = yuv_matrix(ctx->outputs[0]->colorspace); // v7.1
+#endif
+
+    char *easing = s->samples ? av_strdup(s->easing_str ? s->easing_str : "linear") : NULL; // before parsing
     ret = parse_easing(ctx);
+    if (ret >= 0 && easing)
+        ret = xe_log_samples(ctx, easing);
+    av_free(easing);
+    if (ret < 0)
+        return ret;
+
+    ret = xe_config_steps(ctx);
     if (ret < 0)
         return ret;
 
     ret = parse_xtransition(ctx);
+    if (ret >= 0 && s->mask && (!ret || s->transition != CUSTOM))
+        return xe_error(ctx, "option mask applies to the custom transition only, not %s\n", s->transition_str);
+    RowBand band[2];
+    if (ret >= 0 && s->incremental && !dirty_rows(s, 2, 0, 1, band))
+        xe_warning(ctx, "incremental does not apply to transition %s, rendered in full\n", s->transition_str);
     if (ret != 0)
         return ret; // 1 if xfade transition
 
@@ -2901,16 +5304,17 @@ static int config_xfade_easing(AVFilterContext *ctx)
 #endif
     k->duration = (float)s->duration / AV_TIME_BASE; // seconds
     k->r = (float)l->w / l->h;
-    k->n = s->nb_planes;
     k->mw = l->w - 1;
     k->mh = l->h - 1;
     k->mv = s->max_value;
     k->is_rgb = s->is_rgb;
-    k->is_16 = s->depth > 8;
-    s->transitionf = k->is_16 ? xtransition16_transition: xtransition8_transition;
+    s->transitionf = k->is_float ? xtransition32_transition : k->is_16 ? xtransition16_transition: xtransition8_transition;
+    k->regionf = k->is_float ? xtransition32_region : k->is_16 ? xtransition16_region : xtransition8_region;
 
-    XTransition e = { .k = k, .ratio = k->r };
+    bool timed = false;
+    XTransition e = { .k = k, .ratio = k->r, .timed = &timed };
     k->xtransitionf(&e); // cache transition parameters and constants
+    k->is_timed = timed;
     k->init = true;
 
     xe_debug(ctx, "XFadeEasingContext: .framerate=%g .duration=%g .r=%g .n=%d\n .mw=%d .mh=%d .mv=%d .is_16=%d .is_rgb=%d\n",
@@ -2924,10 +5328,18 @@ static void xe_data_free(XFadeEasingContext *k)
 {
     xe_debug(NULL, "xe_data_free\n");
     if (!k) return;
+    xe_uncache(k);
+    av_frame_free(&k->converted.in);
+    av_frame_free(&k->converted.out);
+    for (int i = 0; i < 3; i++)
+        av_frame_free(&k->uv[i]);
     if (k->eargs.type == LINEAR && k->eargs.l.points)
         av_free(k->eargs.l.points);
     if (k->targs.argv)
         av_free(k->targs.argv);
+    xe_program_free(&k->program);
+    av_free(k->steps);
+    batch_free(&k->batch);
     av_freep(&k);
 }
 
@@ -66,6 +66,7 @@ _main() {
     [[ -n $o_list ]] && _list && exit 0
     [[ -n $o_help ]] && _help && exit 0
     [[ -n $o_version ]] && _version && exit 0
+    [[ -n $o_check ]] && { _check $transition; exit $?; }
 
     p_easing_expr=$(_easing "$easing" "$eargs") # get easing expr
     [[ -z $p_easing_expr ]] && exit $ERROR
@@ -73,12 +74,16 @@ _main() {
 
     transition_expr=$(_transition $transition "$targs") # get transition expr
     [[ -z $transition_expr ]] && exit $ERROR
+    if [[ -n $o_mask ]]; then # input weight for the xfade mask option
+        transition_expr=$(_mask "$transition_expr") || exit $ERROR
+    fi
 
     expr=$transition_expr # uneased (linear)
     transition_expr=$(gsed -e 's/\<P\>/ld(0)/g' <<<$transition_expr) # expects eased progress in ld(0)
     if [[ $easing != linear || -n $o_easing ]]; then
         expr="$p_easing_expr%n;%n$transition_expr" # chained easing & transition
     fi
+    expr=$(_hoist "$expr")
 
     [[ -n $o_logprogress ]] && expr="if(ld(9)-st(9,floor(time(0))),print(floor((1-P)*100)))%n;%n$expr"
 
@@ -166,7 +171,7 @@ _version() {
 _opts() {
     ffmpeg -hide_banner --help filter=xfade | grep -q easing && o_native=true # detect native build
     local OPTIND OPTARG opt
-    while getopts ':t:e:b:x:as:p:m:q:c:v:o:r:f:z:d:i:l:jnu:k:LHVXIPT:KD' opt; do
+    while getopts ':t:e:b:x:as:FM:p:m:q:c:v:o:r:f:z:d:i:l:jnu:k:LHVXIPT:KOD' opt; do
         case $opt in
         t) o_transition=$OPTARG ;;
         e) o_easing=$OPTARG ;;
@@ -174,6 +179,8 @@ _opts() {
         x) o_expr=$OPTARG ;;
         a) o_xappend=true ;;
         s) o_xformat=$OPTARG ;;
+        F) o_hoist=true ;;
+        M) o_mask=$OPTARG ;;
         p) o_plot=$OPTARG ;;
         m) o_pmultiple=$OPTARG ;;
         q) o_ptitle=$OPTARG ;;
@@ -199,12 +206,15 @@ _opts() {
         P) o_logprogress=true ; o_loglevel=info ;;
         T) o_tmp=$OPTARG ;;
         K) o_keep=true ;;
+        O) o_check=true ;;
         :) _error 'missing argument'; _help; return $ERROR ;;
         \?) _error 'invalid option'; _help; return $ERROR ;;
         esac
     done
     shift $(($OPTIND - 1))
     vinputs=("$@")
+    [[ -n $o_mask && ! $o_mask =~ ^[ab]$ ]] && _error "-M expects a or b, got '$o_mask'" && return $ERROR
+    [[ -n $o_mask && ${o_transition-$TRANSITION} == gl_random ]] && _error '-M does not apply to gl_random' && return $ERROR
     return 0
 }
 
@@ -361,10 +371,11 @@ _xfade() { # offset duration easing eargs transition targs expr reverse
             x=$(_transition $(_randgl))
             t=$(gsed -e "s/\<P\>/ld(0)/g" <<<$x)
             [[ $e != linear || -n $o_easing ]] && e=$(_easing $e) e=${e%:*} x="$e%n;%n$t"
-            x=$(_expand '%n%X' "$x")
+            x=$(_expand '%n%X' "$(_hoist "$x")")
         fi
         if [[ -n $x ]]; then # have expr
             xfade+=":transition=custom:expr='$x'"
+            [[ -n $o_mask ]] && xfade+=":mask=$o_mask"
         else # vanilla
             xfade+=":transition=$t"
         fi
@@ -372,6 +383,61 @@ _xfade() { # offset duration easing eargs transition targs expr reverse
     echo "$xfade"
 }
 
+# hoist frame invariants: the easing and leading statements using only P, W, H and constants
+# run once per frame, guarded by progress, with values read later kept in unused st()/ld() vars
+# (a guard on ifnot(X+Y+PLANE, …) would skip slice jobs not starting at the first pixel)
+_hoist() { # expr
+    [[ -z $o_hoist ]] && echo "$1" && return
+    _heredoc HOIST | gawk -v x="$1" -v reserve=$o_logprogress -f-
+}
+
+# optimise a generated expression: fold constants, forward stores read once, drop dead stores,
+# keep repeated subexpressions in unused st()/ld() vars and reduce x^2 to x*x and x-floor(x) to mod(x,1)
+# (the first clip() arg is evaluated twice by eval.c so loads are not forwarded into it;
+# st()/ld() vars persist between pixels, so vars read before stored are untouched and none are reallocated)
+_optimise() { # expr
+    _heredoc OPTIMISE | gawk -v x="$1" -v reserve=$o_logprogress -v check=$o_check -f-
+}
+
+# check the optimiser (option -O): evaluate each transition before and after _optimise as eval.c would
+# over a 16x12 grid of synthetic pixels, 13 progress steps and planes 0-2, registers carrying between
+# pixels, and report node evaluations and any difference (bitwise, NaN equal to NaN)
+_check() { # transition|all
+    local t ts=$1 a=$targs n0 n1 r n=0 d=0 u=0 e=0 c0=0 c1=0
+    [[ $1 == all ]] && a= ts=$(_heredoc LIST | gawk -f- $0 | gawk -F "$T" '$1 != "gl_random" && !$5 { print $1 }')
+    for t in $ts; do
+        read n0 n1 r <<<$(_transition $t "$a")
+        [[ -z $r ]] && return $ERROR
+        printf '%-24s %8d %8d %7s %s\n' $t $n0 $n1 $(_percent $n0 $n1) $r
+        case $r in
+        identical) c0=$((c0+n0)) c1=$((c1+n1)) n=$((n+1)); [[ $((n1*20)) -lt $((n0*19)) ]] && e=$((e+1)) ;;
+        different) d=$((d+1)) ;;
+        *) u=$((u+1)) ;; # unparsed or unsupported
+        esac
+    done
+    echo "$n identical, $d different, $u unchecked; node evaluations $c0 -> $c1 ($(_percent $c0 $c1)), $e reduced by over 5%"
+    [[ $d -eq 0 ]]
+}
+
+# percentage change
+_percent() { # from to
+    _calc "$1 ? sprintf(\"%+.1f%%\", ($2 - $1) * 100 / $1) : \"-\""
+}
+
+# reduce a generated expression to the weight of input a or b (option -M) for the xfade mask option,
+# which mixes every plane as the final if()/ifnot() choice or A, B mix does; fails if the weight
+# depends on the plane or its samples (PLANE, A, B, a0()-b3() outside the choice)
+_mask() { # expr
+    local m=$(_heredoc MASK | gawk -v x="$1" -v mode=$o_mask -f-) other=a
+    [[ $o_mask == a ]] && other=b
+    if [[ -z $m ]]; then
+        _error "'$transition' has no mask form: its output is not a mix of A and B by a weight common to all planes"
+        return $ERROR
+    fi
+    [[ $m == \~* ]] && _warning "with mask=$o_mask the output may differ by rounding from the full expression, try -M $other"
+    echo "${m:1}"
+}
+
 # calculate expression using awk
 _calc() { # expr
     gawk -e "BEGIN { ORS = \"\"; print ($1) }"
@@ -2246,7 +2312,7 @@ _transition() { # transition args
         r=p_$s # replace
         x=${x//$s/${!r}} # expand
     done
-    echo "$x"
+    _optimise "$x"
     exit 0
 }
 
@@ -2274,7 +2340,7 @@ _plot() { # path easings
     readarray -d : -t easings <<<$m: ; unset easings[-1] # (<<< adds \n)
     local title=${o_ptitle-$PLOTTITLE} legends
     [[ -z $o_ptitle && ${#easings[@]} -eq 1 ]] && title=${easings[0]}
-    local easing expr e
+    local easing expr e list
     local ll=24 # log level = warning
     local logs log plot=0
     rm -f $TMP-plot-*.log
@@ -2283,27 +2349,33 @@ _plot() { # path easings
         [[ $legend =~ \( ]] && legend=${legend%%(*}-$((plot+1))
         legends+=,$legend
         easing=${easing#*=}
-        if [[ -n $o_native ]]; then # use native build
-            e=":easing='$easing'"
-            expr="ifnot(PLANE+X+Y, print(-1, $ll); print(1-ld(0), $ll); print(1-ld(1), $ll)); 0"
-        else
-            expr=$(_easing $easing) expr=${expr%:*}
-            [[ -z $expr ]] && exit $ERROR # CSS?
-            [[ $expr =~ clip ]] && expr=${expr%;*} # don't clip
-            expr+="; ifnot(PLANE+X+Y, print(-1, $ll); print(1-P, $ll); print(1-ld(0), $ll)); 0"
+        plot=$((plot+1))
+        if [[ -n $o_native ]]; then # use native build, sampling all easings in one run below
+            list+="|$easing"
+            continue
         fi
+        expr=$(_easing $easing) expr=${expr%:*}
+        [[ -z $expr ]] && exit $ERROR # CSS?
+        [[ $expr =~ clip ]] && expr=${expr%;*} # don't clip
+        expr+="; ifnot(PLANE+X+Y, print(-1, $ll); print(1-P, $ll); print(1-ld(0), $ll)); 0"
         expr=$(_expand '%x' "$expr")
-        plot=$((plot+1))
         log=$TMP-plot-$plot.log
         logs+=" $log"
         export FFREPORT="file=$log:level=$ll" # prints to log file (doesn't append)
-        local ffopts='-hide_banner -loglevel level+repeat+error'
-        [[ -z $o_native ]] && ffopts+=' -filter_complex_threads 1'
-        ffmpeg $ffopts \
+        ffmpeg -hide_banner -loglevel level+repeat+error -filter_complex_threads 1 \
             -f lavfi -i "color=c=black:s=1x1:r=100:d=3,format=gray" \
             -f lavfi -i "color=c=white:s=1x1:r=100:d=3,format=gray" \
-            -filter_complex "[0][1]xfade=duration=1:offset=1$e:transition=custom:expr='$expr'" -f null -
+            -filter_complex "[0][1]xfade=duration=1:offset=1:transition=custom:expr='$expr'" -f null -
     done
+    if [[ -n $o_native ]]; then # xfade samples option logs each slideshow cut easing as CSV rows at config
+        local i pads=
+        for i in $(seq 0 1 $plot); do pads+="[i$i]"; done
+        log=$TMP-plot-csv.log
+        logs=$log
+        ffmpeg -hide_banner -loglevel info -f lavfi -i "color=c=black:s=1x1:r=100:d=1,format=gray" \
+            -filter_complex "[0]split=$((plot+1))$pads;${pads}xfade=inputs=$((plot+1)):transition=fade:easing='${list#|}':samples=100" \
+            -frames:v 1 -f null - 2> $log
+    fi
     unset FFREPORT # prevent further logging
     local size=$(_size ${o_psize-$PLOTSIZE} $PLOTSIZE)
     local plt=$TMP-plot.plt # gnuplot script
@@ -2415,7 +2487,7 @@ EOT
         [[ $stack == a ]] && stack=v && [[ $transition =~ (up|down|vu|vd|squeezeh|horz) ]] && stack=h
         local cell2="$gap+w0_0"
         [[ $stack == v ]] && cell2="0_h0+$gap"
-        local expr0; [[ $transition =~ _ ]] && expr0=$(_expand '%n%X' "$(_transition $transition)")
+        local expr0; [[ $transition =~ _ ]] && expr0=$(_expand '%n%X' "$(_hoist "$(_transition $transition)")")
         for i in $(seq 0 1 $m); do
             echo "[v$i]split[v${i}a][v${i}b];" >> $fc_script
         done
@@ -2511,6 +2583,568 @@ BEGIN {
 }
 !FUNC
 
+@HOIST # hoist leading frame invariant statements into a guarded block, see _hoist
+function varying(t) { # uses pixel or time dependent variables
+    gsub(/%n/, " ", t)
+    return t ~ /(^|[^A-Za-z0-9_])(X|Y|A|B|PLANE|[ab][0-3]|random|randomi|time|print)([^A-Za-z0-9_]|$)/
+}
+function scan(t, r, inv,   n, j, l, c, o, w, bad) { # reads of r (inv: before its first completed store), sets wrote[r]
+    n = length(t); l = 0; w = 0; bad = 0
+    for (j = 1; j <= n; j++) {
+        c = substr(t, j, 1)
+        if (c == "(") {
+            o[++l] = substr(t, j - 2, 2) == "st" && substr(t, j + 1) ~ ("^ *" r " *,")
+            if (substr(t, j - 2, 2) == "ld" && substr(t, j + 1) ~ ("^ *" r " *\\)") && !(inv && w))
+                bad++
+        } else if (c == ")")
+            w += o[l--]
+    }
+    wrote[r] = w
+    return bad
+}
+function whole(t,   n, j, l) { # t is a single function call
+    n = length(t); l = 0
+    for (j = index(t, "("); j < n; j++)
+        if (substr(t, j, 1) == "(") l++
+        else if (substr(t, j, 1) == ")" && !--l) return 0
+    return substr(t, n) == ")"
+}
+function rename(t, r, f) {
+    gsub("ld\\( *" r " *\\)", "ld(" f ")", t)
+    return t
+}
+function cost(t) { # approximate node count
+    gsub(/%n/, " ", t)
+    return gsub(/[A-Za-z_][A-Za-z0-9_]*|[0-9.]+|[-+*\/^]/, "", t)
+}
+function plan(k,   i, r, state, wr, f, c) { # renames for hoisting k statements, 0 if impossible
+    for (r = 0; r < 10; r++) inv[r] = 0
+    for (i = 1; i <= k; i++) {
+        if (varying(s[i])) return 0
+        for (r = 0; r < 10; r++)
+            if (scan(s[i], r, 1) && !inv[r]) return 0
+        for (r = 0; r < 10; r++)
+            if (wrote[r]) inv[r] = 1
+    }
+    c = 0
+    for (i = 1; i <= k; i++) c += cost(s[i])
+    if (c <= 8) return 0 # guard costs more
+    f = 0
+    for (r = 0; r < 10; r++) {
+        ren[r] = ""; span[r] = k
+        if (!inv[r]) continue
+        state = 0; wr = 0 # state 1 read, 2 ambiguous
+        for (i = k + 1; i <= n; i++) {
+            if (!scan(s[i], r, 0) && !wrote[r])
+                continue
+            if (!wrote[r]) { # read only
+                if (state == 2) return 0
+                state = 1; span[r] = i
+                continue
+            }
+            wr = 1
+            if (s[i] ~ ("^st\\( *" r " *,") && whole(s[i]) && wrote[r] == 1) { # definite store
+                if (scan(s[i], r, 0)) {
+                    if (state == 2) return 0
+                    state = 1; span[r] = i
+                }
+                break
+            }
+            if (scan(s[i], r, 0)) return 0 # conditional store and read
+            state = 2
+        }
+        if (state == 1 && wr) {
+            while (f < 10 && used[f]) f++
+            if (f >= 10) return 0
+            ren[r] = f; used[f] = 1
+        }
+    }
+    return 1
+}
+BEGIN {
+    e = x; l = 0; k = 1; m = length(e); n = 0
+    for (j = 1; j <= m; j++) {
+        c = substr(e, j, 1)
+        if (c == "(") l++
+        else if (c == ")") l--
+        else if (c == ";" && !l) { s[++n] = substr(e, k, j - k); k = j + 1 }
+    }
+    s[++n] = substr(e, k)
+    for (i = 1; i <= n; i++) { sub(/^(%n| )+/, "", s[i]); sub(/(%n| )+$/, "", s[i]) }
+    t = e; gsub(/(ld|st)\( *[0-9] *[,)]/, "", t)
+    if (t ~ /(^|[^A-Za-z0-9_])(ld|st)\(/) { printf "%s", x; exit } # computed register
+    for (r = 0; r < 10; r++) { t = e; used0[r] = gsub("(ld|st)\\( *" r " *[,)]", "", t) > 0 }
+    used0[9] = used0[9] || reserve
+    for (k = n - 1; k > 0; k--) {
+        for (r = 0; r < 10; r++) used[r] = used0[r]
+        for (g = 0; g < 10 && used[g]; g++);
+        if (g == 10) break
+        used[g] = 1
+        if (plan(k)) break
+    }
+    if (k <= 0 || g == 10) { printf "%s", x; exit }
+    h = "ifnot(eq(ld(" g "), P + 1),%n st(" g ", P + 1)"
+    for (i = 1; i <= k; i++) { t = s[i]; gsub(/%n/, "%n ", t); h = h ";%n " t }
+    for (r = 0; r < 10; r++)
+        if (ren[r] != "") {
+            h = h ";%n st(" ren[r] ", ld(" r "))"
+            for (i = k + 1; i <= span[r]; i++) s[i] = rename(s[i], r, ren[r])
+        }
+    h = h "%n)"
+    for (i = k + 1; i <= n; i++) h = h ";%n" s[i]
+    printf "%s", h
+}
+!HOIST
+
+@OPTIMISE # fold constants, forward single-use stores and reuse common subexpressions, see _optimise
+function node(t, v) { T[++nn] = t; V[nn] = v; K[nn] = 0; return nn }
+function op(o, l, r,   n) { n = node("op", o); A[n, 1] = l; A[n, 2] = r; K[n] = 2; return n }
+function neg(c,   n) { n = node("neg", ""); A[n, 1] = c; K[n] = 1; return n }
+function call(f, a, b,   n) { n = node("call", f); A[n, 1] = a; A[n, 2] = b; K[n] = b == "" ? 1 : 2; return n }
+function num(v) { return node("num", v) }
+function peek() { return substr(src, pos, 1) }
+function pexpr(   l) { # cf. libavutil/eval.c parse_expr()
+    l = psub()
+    while (peek() == ";") { pos++; l = op(";", l, psub()) }
+    return l
+}
+function psub(   l) {
+    l = pterm()
+    while (peek() == "+" || peek() == "-") l = op("+", l, pterm()) # sign parsed by factor
+    return l
+}
+function pterm(   l, o) {
+    l = pfactor()
+    while ((o = peek()) == "*" || o == "/") { pos++; l = op(o, l, pfactor()) }
+    return l
+}
+function psign(   c) {
+    c = peek()
+    if (c == "+" || c == "-") pos++
+    return c == "-" ? -1 : 1
+}
+function pfactor(   s, s2, e, e2) { # sign applies after ^, cf. parse_factor()
+    s = psign(); e = pprimary()
+    while (peek() == "^") {
+        pos++; s2 = psign(); e2 = pprimary()
+        e = op("^", e, s2 < 0 ? neg(e2) : e2)
+    }
+    return s < 0 ? neg(e) : e
+}
+function pprimary(   t, n, name) {
+    t = substr(src, pos)
+    if (match(t, /^[-+]?([0-9]+\.?[0-9]*|\.[0-9]+)([eE][-+]?[0-9]+)?/)) {
+        pos += RLENGTH
+        return num(substr(t, 1, RLENGTH))
+    }
+    if (substr(t, 1, 1) == "(") {
+        pos++; n = pexpr()
+        if (peek() != ")") fail = 1
+        pos++
+        return n
+    }
+    if (!match(t, /^[A-Za-z_][A-Za-z0-9_]*/)) { fail = 1; pos++; return num(0) }
+    name = substr(t, 1, RLENGTH); pos += RLENGTH
+    if (peek() != "(") return node("var", name)
+    n = node("call", name); pos++
+    do A[n, ++K[n]] = pexpr(); while (peek() == "," && pos++)
+    if (peek() != ")") fail = 1
+    pos++
+    return n
+}
+function isnum(n) { return T[n] == "num" }
+function fmt(v,   p, s) { # shortest exact
+    for (p = 15; p <= 17; p++) { s = sprintf("%." p "g", v); if (s + 0 == v) break }
+    return s
+}
+function finite(v) { return v == v && v - v == 0 }
+function leaf(n) { return T[n] == "num" || T[n] == "var" || (T[n] == "call" && V[n] == "ld" && isnum(A[n, 1])) }
+function same(a, b) { return key(a) == key(b) }
+# constant folding and strength reduction, returns replacement node
+function fold(n,   i, l, r, v) {
+    for (i = 1; i <= K[n]; i++) A[n, i] = fold(A[n, i])
+    l = A[n, 1]; r = A[n, 2]
+    if (T[n] == "neg") {
+        if (isnum(l)) return num(fmt(-V[l]))
+        if (T[l] == "neg") return A[l, 1]
+        return n
+    }
+    if (T[n] == "call") {
+        if (V[n] == "pow" && isnum(r) && (V[r] + 0 == 1 || V[r] + 0 == 2 && leaf(l))) return fold(op("^", l, r))
+        return n
+    }
+    if (T[n] != "op") return n
+    if (V[n] == ";") return n
+    if (isnum(l) && isnum(r)) {
+        if (V[n] == "+") v = V[l] + V[r]
+        else if (V[n] == "*") v = V[l] * V[r]
+        else if (V[n] == "/" && V[r] + 0 != 0) v = V[l] / V[r]
+        else return n
+        if (finite(v)) { changed++; return num(fmt(v)) }
+        return n
+    }
+    if (V[n] == "*" && isnum(r) && V[r] + 0 == 1) { changed++; return l }
+    if (V[n] == "*" && isnum(l) && V[l] + 0 == 1) { changed++; return r }
+    if (V[n] == "/" && isnum(r) && V[r] + 0 == 1) { changed++; return l }
+    if (V[n] == "+" && isnum(r) && V[r] == "-0") { changed++; return l } # x - 0
+    if (V[n] == "^" && isnum(r)) {
+        if (V[r] + 0 == 1) { changed++; return l }
+        if (V[r] + 0 == 2 && leaf(l)) { changed++; return op("*", l, l) }
+    }
+    if (V[n] == "+" && T[r] == "neg" && T[A[r, 1]] == "call" && V[A[r, 1]] == "floor" && leaf(l) && same(l, A[A[r, 1], 1])) {
+        changed++; return call("mod", l, num(1)) # x - floor(x)
+    }
+    return n
+}
+function key(n,   s, i) { # canonical inline text
+    if (T[n] == "num") return V[n] + 0 == 0 ? "0" : fmt(V[n] + 0)
+    if (T[n] == "var") return V[n]
+    if (T[n] == "neg") return isnum(A[n, 1]) ? key(num(-V[A[n, 1]])) : "-(" key(A[n, 1]) ")"
+    if (T[n] == "op") return "(" key(A[n, 1]) V[n] key(A[n, 2]) ")"
+    s = V[n] "("
+    for (i = 1; i <= K[n]; i++) s = s (i > 1 ? "," : "") key(A[n, i])
+    return s ")"
+}
+function impure(f) { return f ~ /^(st|while|random|randomi|time|print|taylor|root)$/ }
+function varying(n) { return n ~ /(^|[^A-Za-z0-9_])(X|Y|A|B|PLANE|[ab][0-3])([^A-Za-z0-9_]|$)/ }
+# analysis in evaluation order: post-order index, absolute conditionality, stores and loads
+function walk(n, cond, opq, dup,   i, f, c) {
+    if (T[n] == "call") {
+        f = V[n]
+        if (f == "while" || f == "taylor" || f == "root" || f ~ /^random/) { opq = 1; cond = 1 }
+        if (f ~ /^[ab][0-3]$/ && hasst(n)) { opq = 1; cond = 1 } # unspecified argument order
+        for (i = 1; i <= K[n]; i++) {
+            c = cond || ((f == "if" || f == "ifnot") && i > 1) || (f == "between" && i == 3) || (f ~ /^[ab][0-3]$/ && i == 2)
+            walk(A[n, i], c, opq, dup || (f == "clip" && i == 1)) # clip() evaluates its first argument twice
+        }
+        if (f == "st" && isnum(A[n, 1])) { SR[++ns] = V[A[n, 1]] + 0; SI[ns] = idx + 1; SC[ns] = cond }
+        else if (f == "st" || f == "random" || f == "randomi" || f == "taylor" || f == "root") bad = 1 # computed or implicit register
+        if (f == "ld" && isnum(A[n, 1])) { LR[++nl] = V[A[n, 1]] + 0; LI[nl] = idx + 1; LO[nl] = opq || dup; LN[nl] = n }
+        else if (f == "ld") bad = 1
+    } else
+        for (i = 1; i <= K[n]; i++) walk(A[n, i], cond, opq, dup)
+    IDX[n] = ++idx; COND[n] = cond; OPQ[n] = opq; DUP[n] = dup
+}
+function hasst(n,   i) {
+    if (T[n] == "call" && impure(V[n])) return 1
+    for (i = 1; i <= K[n]; i++) if (hasst(A[n, i])) return 1
+    return 0
+}
+function cost(n,   i, c) { c = T[n] != "neg"; for (i = 1; i <= K[n]; i++) c += cost(A[n, i]); return c }
+function reads(n,   i, s) { # registers read, as ,r,
+    s = T[n] == "call" && V[n] == "ld" ? "," V[A[n, 1]] + 0 "," : ""
+    for (i = 1; i <= K[n]; i++) s = s reads(A[n, i])
+    return s
+}
+function clobbered(rs, from, to,   i) { # store to any of rs between indexes
+    for (i = 1; i <= ns; i++)
+        if (SI[i] > from && SI[i] < to && index(rs, "," SR[i] ",")) return 1
+    return 0
+}
+function analyse() { nl = ns = idx = bad = 0; walk(root, 0, 0, 0) }
+function replace(old, new,   n, i) { # in the whole tree
+    if (root == old) { root = new; return }
+    for (n = 1; n <= nn; n++)
+        for (i = 1; i <= K[n]; i++)
+            if (A[n, i] == old && n != new) A[n, i] = new
+}
+function statements(   n, c) { # top-level statements, in order
+    c = 0; n = root
+    while (T[n] == "op" && V[n] == ";") { STP[++c] = n; n = A[n, 1] } # parent chain
+    nst = c + 1; ST[1] = n
+    for (c = nst; c > 1; c--) ST[nst - c + 2] = A[STP[c - 1], 2]
+}
+# remove dead stores and forward single-use varying stores to their load
+function stores(   s, n, r, i, first, kill, nld, ld1, e) {
+    statements()
+    for (s = 1; s < nst; s++) {
+        n = ST[s]
+        if (T[n] != "call" || V[n] != "st" || !isnum(A[n, 1])) continue
+        r = V[A[n, 1]] + 0; e = A[n, 2]
+        if (hasst(e) || r == 0) continue
+        first = 1e9
+        for (i = 1; i <= ns; i++) if (SR[i] == r && !SC[i] && SI[i] < first) first = SI[i]
+        for (i = 1; i <= nl; i++) if (LR[i] == r && LI[i] < first) break
+        if (i <= nl) continue # read before stored: carried to the next pixel
+        kill = 1e9
+        for (i = 1; i <= ns; i++) if (SR[i] == r && SI[i] > IDX[n] && !SC[i] && SI[i] < kill) kill = SI[i]
+        for (i = 1; i <= ns; i++) if (SR[i] == r && SI[i] > IDX[n] && SI[i] < kill && SC[i]) break
+        if (i <= ns) continue # conditionally overwritten
+        nld = 0
+        for (i = 1; i <= nl; i++) if (LR[i] == r && LI[i] > IDX[n] && LI[i] < kill) { nld++; ld1 = i }
+        if (nld == 0) { drop(s); changed++; return 1 }
+        if (nld == 1 && !LO[ld1] && varying(key(e)) && !clobbered(reads(e), IDX[n], LI[ld1])) {
+            replace(LN[ld1], e); drop(s); changed++; return 1
+        }
+    }
+    return 0
+}
+function drop(s) { # remove statement s < nst
+    if (s == 1) { if (nst == 2) root = ST[2]; else A[STP[nst - 2], 1] = ST[2]; return }
+    # statement s is the right operand of the ; whose left is statements 1..s-1
+    replace(parent(ST[s]), A[parent(ST[s]), 1])
+}
+function parent(c,   n, i) { for (n = 1; n <= nn; n++) for (i = 1; i <= K[n]; i++) if (A[n, i] == c) return n; return 0 }
+# common subexpression elimination into unused registers
+function cse(   n, k, m, i, u, bu, best, bc, c, rs, f, cnt) {
+    for (f = 1; f < 10 && used[f]; f++);
+    if (f == 10) return 0
+    delete seen
+    for (n = 1; n <= nn; n++) { # reachable nodes have an index
+        if (!(n in IDX) || OPQ[n] || leaf(n) || T[n] == "neg" || hasst(n) || (T[n] == "call" && V[n] == "time")) continue
+        k = key(n); seen[k] = seen[k] " " n
+    }
+    best = ""; bc = 0
+    for (k in seen) {
+        m = split(seen[k], occ, " ")
+        if (m < 2) continue
+        c = cost(occ[1]); rs = reads(occ[1])
+        u = 0
+        for (i = 1; i <= m; i++) if (!COND[occ[i]] && !DUP[occ[i]] && (!u || IDX[occ[i]] < IDX[u])) u = occ[i]
+        if (!u) continue
+        cnt = 0
+        for (i = 1; i <= m; i++) if (IDX[occ[i]] > IDX[u] && !clobbered(rs, IDX[u], IDX[occ[i]])) cnt += COND[occ[i]] ? 0.5 : 1
+        if (cnt * (c - 2) > 2 && cnt * (c - 2) > bc) { bc = cnt * (c - 2); best = k; bu = u }
+    }
+    if (best == "") return 0
+    m = split(seen[best], occ, " "); rs = reads(bu)
+    for (i = 1; i <= m; i++)
+        if (IDX[occ[i]] > IDX[bu] && !clobbered(rs, IDX[bu], IDX[occ[i]]))
+            replace(occ[i], call("ld", num(f)))
+    replace(bu, call("st", num(f), bu))
+    used[f] = 1; changed++
+    return 1
+}
+function pr(n,   s, i, l, r) { # inline, script spacing
+    if (T[n] == "num" || T[n] == "var") return V[n]
+    if (T[n] == "neg") return "-" (prec(A[n, 1]) >= 3 ? pr(A[n, 1]) : "(" pr(A[n, 1]) ")")
+    if (T[n] == "op") {
+        l = A[n, 1]; r = A[n, 2]
+        if (V[n] == ";") return pr(l) "; " pr(r)
+        if (V[n] == "^") return (prec(l) >= 3 ? pr(l) : "(" pr(l) ")") "^" (prec(r) >= 4 || (T[r] == "neg" && prec(A[r, 1]) >= 4) ? pr(r) : "(" pr(r) ")")
+        if (V[n] == "+") return lead(r) ? pr(l) " - " strip(r) : pr(l) " + " (prec(r) >= 2 ? pr(r) : "(" pr(r) ")")
+        return (prec(l) >= 2 ? pr(l) : "(" pr(l) ")") " " V[n] " " right(r)
+    }
+    s = V[n] "("
+    for (i = 1; i <= K[n]; i++) s = s (i > 1 ? ", " : "") pr(A[n, i])
+    return s ")"
+}
+function right(n) { # right operand of * or /
+    return prec(n) >= 3 || lead(n) && T[n] != "op" ? pr(n) : "(" pr(n) ")"
+}
+function block(n, ind) { # statement sequence, one per line
+    if (T[n] == "op" && V[n] == ";") return block(A[n, 1], ind) ";%n" ind stmt(A[n, 2], ind)
+    return stmt(n, ind)
+}
+function stmt(n, ind,   s, i) { # long conditionals split over lines
+    s = pr(n)
+    if (T[n] != "call" || (V[n] != "if" && V[n] != "ifnot") || length(ind s) <= 72) return s
+    s = V[n] "(" pr(A[n, 1])
+    for (i = 2; i <= K[n]; i++) s = s ",%n" ind " " block(A[n, i], ind " ")
+    return s "%n" ind ")"
+}
+function lead(n) { # term starts with a minus sign
+    if (T[n] == "neg") return 1
+    if (T[n] == "num") return V[n] ~ /^-/
+    return T[n] == "op" && (V[n] == "*" || V[n] == "/") && lead(A[n, 1])
+}
+function strip(n) { # print term without its leading minus sign
+    if (T[n] == "neg") return prec(A[n, 1]) >= 2 ? pr(A[n, 1]) : "(" pr(A[n, 1]) ")"
+    if (T[n] == "num") return substr(V[n], 2)
+    return strip(A[n, 1]) " " V[n] " " right(A[n, 2])
+}
+function prec(n) {
+    if (T[n] == "op") return V[n] == ";" ? 0 : V[n] == "+" ? 1 : V[n] == "^" ? 3 : 2
+    if (T[n] == "neg") return 2
+    if (T[n] == "num" && V[n] ~ /^-/) return 2
+    return 4
+}
+# check mode: evaluation as libavutil/eval.c does, counting node evaluations (neg is folded into its operand)
+function floor_(v,   i) { i = int(v); return i > v ? i - 1 : i }
+function ceil_(v,   i) { i = int(v); return i < v ? i + 1 : i }
+function bits(a, b, o,   r, m) { # bitand, bitor of non-negative integers
+    a = int(a); b = int(b); r = 0
+    for (m = 1; a > 0 || b > 0; m *= 2) {
+        if (o == "and" ? a % 2 && b % 2 : a % 2 || b % 2) r += m
+        a = int(a / 2); b = int(b / 2)
+    }
+    return r
+}
+function reg(v) { v = int(v); return v < 0 ? 0 : v > 9 ? 9 : v }
+function pix(f, a, b,   i, j) { # a0() to b3(): clipped sample of a synthetic frame
+    i = int(a < 0 ? 0 : a > VAR["W"] - 1 ? VAR["W"] - 1 : a)
+    j = int(b < 0 ? 0 : b > VAR["H"] - 1 ? VAR["H"] - 1 : b)
+    return (i * 31 + j * 7 + substr(f, 2) * 5 + (substr(f, 1, 1) == "b") * 13) % 256
+}
+function ev(n,   f, a, b, c, d) {
+    if (T[n] == "neg") return -ev(A[n, 1])
+    evals++
+    if (T[n] == "num") return V[n] + 0
+    if (T[n] == "var") { if (!(V[n] in VAR)) unknown = 1; return VAR[V[n]] }
+    if (T[n] == "op") {
+        if (V[n] == ";") { ev(A[n, 1]); return ev(A[n, 2]) }
+        a = ev(A[n, 1]); b = ev(A[n, 2])
+        if (V[n] == "+") return a + b
+        if (V[n] == "*") return a * b
+        if (V[n] == "/") return b ? a / b : a * INF
+        return a ^ b
+    }
+    f = V[n]
+    if (f == "if" || f == "ifnot") return (ev(A[n, 1]) != 0) == (f == "if") ? ev(A[n, 2]) : K[n] > 2 ? ev(A[n, 3]) : 0
+    if (f == "while") { d = NAN; while (ev(A[n, 1]) != 0) d = ev(A[n, 2]); return d }
+    if (f == "clip") { # first argument evaluated twice
+        a = ev(A[n, 1]); b = ev(A[n, 2]); c = ev(A[n, 3])
+        if (a != a || b != b || c != c || b > c) return NAN
+        a = ev(A[n, 1])
+        return a < b ? b : a > c ? c : a
+    }
+    if (f == "between") { a = ev(A[n, 1]); return a >= ev(A[n, 2]) && a <= ev(A[n, 3]) }
+    if (f == "st") { a = ev(A[n, 1]); return REG[reg(a)] = ev(A[n, 2]) }
+    a = ev(A[n, 1]); if (K[n] > 1) b = ev(A[n, 2])
+    if (f == "ld") return REG[reg(a)]
+    if (f ~ /^[ab][0-3]$/) return pix(f, a, b)
+    if (f == "abs") return a < 0 ? -a : a
+    if (f == "sgn") return (a > 0) - (a < 0)
+    if (f == "not") return a == 0
+    if (f == "floor") return floor_(a)
+    if (f == "ceil") return ceil_(a)
+    if (f == "trunc") return int(a)
+    if (f == "round") return a < 0 ? -floor_(-a + 0.5) : floor_(a + 0.5)
+    if (f == "sqrt") return sqrt(a)
+    if (f == "exp") return exp(a)
+    if (f == "log") return log(a)
+    if (f == "sin") return sin(a)
+    if (f == "cos") return cos(a)
+    if (f == "tan") return sin(a) / cos(a)
+    if (f == "asin") return atan2(a, sqrt(1 - a * a))
+    if (f == "acos") return atan2(sqrt(1 - a * a), a)
+    if (f == "atan") return atan2(a, 1)
+    if (f == "atan2") return atan2(a, b)
+    if (f == "hypot") return sqrt(a * a + b * b)
+    if (f == "pow") return a ^ b
+    if (f == "mod") return a - floor_(b ? a / b : a * INF) * b
+    if (f == "max") return a > b ? a : b
+    if (f == "min") return a < b ? a : b
+    if (f == "gt") return a > b
+    if (f == "gte") return a >= b
+    if (f == "lt") return a < b
+    if (f == "lte") return a <= b
+    if (f == "eq") return a == b
+    if (f == "bitand") return bits(a, b, "and")
+    if (f == "bitor") return bits(a, b, "or")
+    unknown = 1
+    return 0
+}
+function run(n, r,   i, v) { # with the registers of side r, carried between evaluations
+    for (i = 0; i < 10; i++) REG[i] = R[r, i]
+    evals = 0; v = ev(n); E[r] += evals
+    for (i = 0; i < 10; i++) R[r, i] = REG[i]
+    return v
+}
+function verify(y,   r0, r1, fr, p, yy, xx, u, v, i, differ) { # prints node evaluations before, after and result
+    src = x; gsub(/%n|[ \t\n]/, "", src); pos = 1; fail = 0; r0 = pexpr()
+    src = y; gsub(/%n|[ \t\n]/, "", src); pos = 1; r1 = pexpr()
+    if (fail || pos <= length(src)) { print "0 0 unparsed"; return }
+    INF = 2 ^ 1024; NAN = INF - INF; unknown = 0; differ = 0
+    VAR["W"] = 16; VAR["H"] = 12; VAR["PI"] = atan2(0, -1); VAR["E"] = exp(1); VAR["PHI"] = (1 + sqrt(5)) / 2
+    for (fr = 0; fr <= 12 && !differ; fr++) {
+        VAR["P"] = VAR["PU"] = VAR["PE"] = 1 - fr / 12
+        for (yy = 0; yy < VAR["H"] && !differ; yy++)
+            for (xx = 0; xx < VAR["W"] && !differ; xx++)
+                for (p = 0; p < 3; p++) {
+                    VAR["X"] = xx; VAR["Y"] = yy; VAR["PLANE"] = p
+                    VAR["A"] = (xx * 31 + yy * 7 + p * 5) % 256; VAR["B"] = (xx * 31 + yy * 7 + p * 5 + 13) % 256
+                    u = run(r0, 0); v = run(r1, 1)
+                    if (u != v && (u == u || v == v)) { differ = 1; break }
+                }
+    }
+    print E[0], E[1], unknown ? "unsupported" : differ ? "different" : "identical"
+}
+BEGIN {
+    src = x; gsub(/%n|[ \t\n]/, "", src)
+    pos = 1; fail = 0; root = pexpr()
+    if (fail || pos <= length(src)) { if (check) print "0 0 unparsed"; else printf "%s", x; exit } # not parsed, leave as is
+    analyse()
+    if (bad) { if (check) verify(x); else printf "%s", x; exit }
+    for (r = 0; r < 10; r++) used[r] = r == 0 || (r == 9 && reserve) # ld(0) is eased progress
+    for (i = 1; i <= ns; i++) used[SR[i]] = 1
+    for (i = 1; i <= nl; i++) used[LR[i]] = 1
+    k = key(root)
+    for (pass = 0; pass < 100; pass++) {
+        changed = 0
+        root = fold(root)
+        delete IDX; analyse()
+        if (stores()) { delete IDX; analyse() }
+        if (!changed && !cse()) break
+        delete IDX; analyse()
+    }
+    y = key(root) == k ? x : block(root, "") # keep layout if nothing gained
+    if (check) verify(y); else printf "%s", y
+}
+!OPTIMISE
+
+@MASK # weight of input a or b in place of the mixed output, see _mask
+function parts(t, sep, out,   n, j, l, c, k) { # at depth 0, returns count
+    n = 0; l = 0; k = 1
+    for (j = 1; j <= length(t); j++) {
+        c = substr(t, j, 1)
+        if (c == "(") l++
+        else if (c == ")") l--
+        else if (index(sep, c) && !l) { out[++n] = substr(t, k, j - k); k = j + 1 }
+    }
+    out[++n] = substr(t, k)
+    return n
+}
+function closes(t, j,   n, l) { # parenthesis at j closes at the end of t
+    n = length(t); l = 0
+    for (; j < n; j++)
+        if (substr(t, j, 1) == "(") l++
+        else if (substr(t, j, 1) == ")" && !--l) return 0
+    return substr(t, n) == ")"
+}
+function unwrap(t) {
+    while (substr(t, 1, 1) == "(" && closes(t, 1)) t = substr(t, 2, length(t) - 2)
+    return t
+}
+function group(t,   o) { return parts(t, "+-*/^", o) > 1 ? "(" t ")" : t }
+function plain(t) { # same for every plane
+    return t !~ /(^|[^A-Za-z0-9_])(A|B|PLANE|[ab][0-3])([^A-Za-z0-9_]|$)/
+}
+function weight(t,   s, n, i, h, f, a, u, v, x, y, w) { # of input mode in t, "" if none
+    t = unwrap(t)
+    if (t == "A" || t == "B") return t == toupper(mode) ? "1" : "0"
+    if ((n = parts(t, ";", s)) > 1) { # statements then choice
+        h = ""
+        for (i = 1; i < n; i++) { if (!plain(s[i])) return ""; h = h s[i] (depth ? ";" : ";%n") }
+        depth++; w = weight(s[n]); depth--
+        return w == "" ? "" : h w
+    }
+    if (match(t, /^(if|ifnot)\(/) && closes(t, RLENGTH)) { # choice
+        f = substr(t, 1, RLENGTH - 1)
+        if (parts(substr(t, RLENGTH + 1, length(t) - RLENGTH - 1), ",", a) != 3 || !plain(a[1])) return ""
+        depth++; u = weight(a[2]); v = weight(a[3]); depth--
+        return u == "" || v == "" ? "" : f "(" a[1] "," u "," v ")"
+    }
+    if (parts(t, "+", s) != 2) return "" # mix X*x+Y*y
+    for (i = 1; i <= 2; i++) {
+        if (parts(s[i], "-/", a) > 1 || parts(s[i], "*", a) != 2) return ""
+        a[1] = unwrap(a[1]); a[2] = unwrap(a[2])
+        if (a[2] == "A" || a[2] == "B") { f = a[1]; a[1] = a[2]; a[2] = f }
+        if (a[1] != "A" && a[1] != "B" || !plain(a[2])) return ""
+        if (a[1] == toupper(mode)) x = a[2]; else y = a[2]
+    }
+    if (x == "" || y == "") return ""
+    if (y == "1-" group(x)) return x # as the mask mixes: exact
+    if (x == "1-" group(y)) { inexact = 1; return x }
+    return ""
+}
+BEGIN {
+    src = x; gsub(/%n|[ \t\n]/, "", src)
+    w = weight(src)
+    if (w != "") printf "%s%s", inexact ? "~" : "=", w
+}
+!MASK
+
 @EASINGS
 BEGIN {
     while (match(m, /^ *([^=]+=)?[a-z-]+(\([^)]*\))?,? */)) {
@@ -2540,6 +3174,13 @@ BEGIN {
     # https://eepower.com/resistor-guide/resistor-standards-and-codes/resistor-color-code/
     split("993300,ff0000,ff9900,fdee00,99cc00,3366ff,7030a0,8c8c8c", lc, ",") # Aureolin yellow
 }
+/^".*",[-0-9.e]+,[-0-9.e]+$/ { # native samples CSV: "easing",progress,eased
+    n = split($0, a, ",")
+    if (a[n-1] == 0) # start of easing
+        leg = (++plot <= plots) ? legend[plot] : ""
+    val[leg,int(a[n-1] * 100 + 0.5)] = +a[n]
+    next
+}
 $0 !~ /\[warning\]/ || $NF !~ /^[-0-9]/ { next } # non-data
 $NF ~ /^-1\.0+$/ { # start of data pair
     if (FILENAME != fn) { # new file
@@ -2788,6 +3429,13 @@ Options:
           for the uneased transition expression only, omit -e option and use %x or %X
        %P, %G, %Z, uncondensed versions of %p, %g, %z, for -/filter_complex script files
        %n inserts a newline
+    -F hoist frame invariants out of the per pixel custom expression (default: no)
+       the easing and leading statements of P, W, H and constants run once per frame,
+       guarded by ifnot(eq(ld(n), P + 1), …) with unused vars n, so %x and %X differ
+       needs -filter_complex_threads 1 as usual; the custom ffmpeg build is thread-safe
+    -M emit the input weight for xfade option mask=a or mask=b instead of the mixed output
+       (custom ffmpeg only), for expressions ending in a choice or mix of A and B
+       that is the same for every plane; warns if it may differ by rounding
     -p easing plot filename (default: no plot), accepts expansions
        formats: gif, jpg, png, svg, pdf, eps, html <canvas>, from file extension
     -m multiple easings to plot on one graph (default: the -e easing)
@@ -2836,6 +3484,8 @@ Options:
     -P log xfade progress percentage using custom expression print() function (implies -I)
     -T temporary file directory (default: $TMPDIR)
     -K keep temporary files if temporary directory is not $TMPDIR
+    -O check the optimiser on the -t transition, or every transition with -t all:
+       prints node evaluations before and after and whether the results are identical
 Notes:
     1. point the shebang path to a bash4 location (defaults to MacPorts install)
     2. this script requires Bash 4 (2009), ffmpeg, ffprobe, gawk, gsed, seq